@@ -0,0 +1,248 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+/*
+ * On target benchmark, every case is timed with DWT cycle counter and the best
+ * of BENCH_REPEAT runs is printed over USART2 (PA2, 115200 8N1). Display
+ * contexts of bsp_lcd.c (HAL) and bsp_lcd_fast.c (registers) are copied and
+ * altered to compare BSPs, callback flavours and busy flag handling of the
+ * same wiring.
+ */
+
+#include "hd44780.h"
+#include "bsp_lcd.h"
+#include "bsp_uart.h"
+#include "stm32f4xx_hal.h"
+#include "string.h"
+
+#define BENCH_BAUDRATE  (115200U)
+#define BENCH_REPEAT    (8U)
+#define BENCH_ROWS      (4U)
+#define BENCH_COLUMNS   (20U)
+
+typedef hd44780_ret_e (*bench_case_fn)(const hd44780_ctx* const ctx);
+
+/* Driver configuration compared on the same wiring */
+typedef struct {
+  const char* name;
+  const hd44780_ctx* (*ctx_get)(void);  /* BSP providing wiring */
+  bool cycle_callbacks;   /* cb_write_cycle and cb_read_cycle instead of per pin callbacks */
+  bool busy_irq;          /* busy flag clear interrupt instead of polling */
+  bool write_only;        /* execution times instead of busy flag */
+} bench_variant;
+
+typedef struct {
+  const char* name;
+  bench_case_fn run;
+} bench_case;
+
+static void dwt_init(void);
+static uint32_t dwt_cycles(void);
+static void bench_print_case(const char* name, uint32_t const cycles, hd44780_ret_e const ret);
+static hd44780_ret_e bench_init(const hd44780_ctx* const ctx);
+static hd44780_ret_e bench_clear(const hd44780_ctx* const ctx);
+static hd44780_ret_e bench_ascii(const hd44780_ctx* const ctx);
+static hd44780_ret_e bench_utf8_rom(const hd44780_ctx* const ctx);
+static hd44780_ret_e bench_utf8_custom(const hd44780_ctx* const ctx);
+static hd44780_ret_e bench_def_char(const hd44780_ctx* const ctx);
+static hd44780_ret_e bench_screen_direct(const hd44780_ctx* const ctx);
+static hd44780_ret_e bench_screen_fb(const hd44780_ctx* const ctx);
+static void bench_variant_run(const bench_variant* const variant);
+void SysTick_Handler(void);
+
+static uint8_t fb_cells[BENCH_ROWS * BENCH_COLUMNS];
+static uint8_t fb_shadow[BENCH_ROWS * BENCH_COLUMNS];
+static hd44780_fb fb = { .cells = fb_cells, .shadow = fb_shadow };
+
+/* Every screen refresh differs from previous one in every cell */
+static uint8_t frame;
+
+static const bench_variant variants[] = {
+  { "HAL cycle callbacks, busy flag irq",   hd44780_instance_ctx_get,      true,  true,  false },
+  { "HAL cycle callbacks, busy flag poll",  hd44780_instance_ctx_get,      true,  false, false },
+  { "HAL pin callbacks, busy flag poll",    hd44780_instance_ctx_get,      false, false, false },
+  { "HAL cycle callbacks, write only",      hd44780_instance_ctx_get,      true,  false, true  },
+  { "fast cycle callbacks, busy flag poll", hd44780_fast_instance_ctx_get, true,  false, false },
+  { "fast pin callbacks, busy flag poll",   hd44780_fast_instance_ctx_get, false, false, false },
+  { "fast cycle callbacks, write only",     hd44780_fast_instance_ctx_get, true,  false, true  },
+};
+
+static const bench_case cases[] = {
+  { "init (warm)",              bench_init },
+  { "clear",                    bench_clear },
+  { "write_text ASCII x20",     bench_ascii },
+  { "write_text UTF-8 ROM x16", bench_utf8_rom },
+  { "write_text UTF-8 CGRAM x8", bench_utf8_custom },
+  { "def_char",                 bench_def_char },
+  { "screen direct 4x20",       bench_screen_direct },
+  { "screen framebuffer 4x20",  bench_screen_fb },
+};
+
+static void dwt_init(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t dwt_cycles(void) {
+  return DWT->CYCCNT;
+}
+
+static void bench_print_case(const char* name, uint32_t const cycles, hd44780_ret_e const ret) {
+  bsp_uart_write("  ");
+  bsp_uart_write(name);
+  for (size_t len = strlen(name); len < 26U; len++) {
+    bsp_uart_write(" ");
+  }
+  bsp_uart_write_u32(cycles, 10U);
+  bsp_uart_write(" cycles");
+  bsp_uart_write_u32(cycles / (SystemCoreClock / 1000000U), 8U);
+  bsp_uart_write(" us");
+  bsp_uart_write((HD44780_OK == ret) ? "\n" : "  FAILED\n");
+}
+
+static hd44780_ret_e bench_init(const hd44780_ctx* const ctx) {
+  return hd44780_init(ctx);
+}
+
+static hd44780_ret_e bench_clear(const hd44780_ctx* const ctx) {
+  return hd44780_clear(ctx);
+}
+
+static hd44780_ret_e bench_ascii(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = hd44780_set_pos(ctx, 0, 0);
+  if (HD44780_OK == ret) {
+    ret = hd44780_write_text(ctx, "dependency free,    ");
+  }
+  return ret;
+}
+
+static hd44780_ret_e bench_utf8_rom(const hd44780_ctx* const ctx) {
+  /* Codepoints found in A00 ROM table, binary searched */
+  hd44780_ret_e ret = hd44780_set_pos(ctx, 1, 0);
+  if (HD44780_OK == ret) {
+    ret = hd44780_write_text(ctx, "25°C 3µs ΣΩπ äöü");
+  }
+  return ret;
+}
+
+static hd44780_ret_e bench_utf8_custom(const hd44780_ctx* const ctx) {
+  /* Glyphs resident in CGRAM since init */
+  hd44780_ret_e ret = hd44780_set_pos(ctx, 2, 0);
+  if (HD44780_OK == ret) {
+    ret = hd44780_write_text(ctx, "èè↑↑🍌🍌è↑");
+  }
+  return ret;
+}
+
+static hd44780_ret_e bench_def_char(const hd44780_ctx* const ctx) {
+  static const uint8_t pattern[8] = {0b00100, 0b01110, 0b11111, 0b11111, 0b11111, 0b01110, 0b00100, 0b00000};
+  return hd44780_def_char(ctx, 7, pattern);
+}
+
+static hd44780_ret_e bench_screen_direct(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  char line[BENCH_COLUMNS + 1];
+
+  frame++;
+  for (uint8_t row = 0U; (HD44780_OK == ret) && (row < BENCH_ROWS); row++) {
+    for (uint8_t column = 0U; column < BENCH_COLUMNS; column++) {
+      line[column] = (char)('A' + ((frame + row + column) % 26U));
+    }
+    line[BENCH_COLUMNS] = '\0';
+    ret = hd44780_set_pos(ctx, row, 0);
+    if (HD44780_OK == ret) {
+      ret = hd44780_write_text(ctx, line);
+    }
+  }
+  return ret;
+}
+
+static hd44780_ret_e bench_screen_fb(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  char line[BENCH_COLUMNS + 1];
+
+  frame++;
+  for (uint8_t row = 0U; (HD44780_OK == ret) && (row < BENCH_ROWS); row++) {
+    for (uint8_t column = 0U; column < BENCH_COLUMNS; column++) {
+      line[column] = (char)('a' + ((frame + row + column) % 26U));
+    }
+    line[BENCH_COLUMNS] = '\0';
+    ret = hd44780_fb_set_pos(ctx, row, 0);
+    if (HD44780_OK == ret) {
+      ret = hd44780_fb_write_text(ctx, line);
+    }
+  }
+  if (HD44780_OK == ret) {
+    ret = hd44780_flush(ctx);
+  }
+  return ret;
+}
+
+static void bench_variant_run(const bench_variant* const variant) {
+  hd44780_ctx ctx = *variant->ctx_get();
+  ctx.framebuffer = &fb;
+  if (!variant->cycle_callbacks) {
+    ctx.cb_write_cycle = NULL;
+    ctx.cb_read_cycle = NULL;
+  }
+  if (!variant->busy_irq) {
+    ctx.cb_busy_wait_begin = NULL;
+    ctx.cb_busy_wait_signalled = NULL;
+  }
+  if (variant->write_only) {
+    /* RW line is wired, driver does not touch it in write only mode */
+    ctx.cb_set_ctrl_pin_state(HD44780_PIN_RW, PIN_RESET);
+    ctx.write_only = true;
+  }
+
+  bsp_uart_write(variant->name);
+  bsp_uart_write("\n");
+  hd44780_ret_e ret = hd44780_init(&ctx);
+  if (HD44780_OK != ret) {
+    bsp_uart_write("  init FAILED\n");
+  }
+  for (size_t i = 0U; (HD44780_OK == ret) && (i < (sizeof(cases) / sizeof(cases[0]))); i++) {
+    uint32_t best = UINT32_MAX;
+    for (uint8_t n = 0U; (HD44780_OK == ret) && (n < BENCH_REPEAT); n++) {
+      uint32_t const start = dwt_cycles();
+      ret = cases[i].run(&ctx);
+      uint32_t const cycles = dwt_cycles() - start;
+      best = (cycles < best) ? cycles : best;
+    }
+    bench_print_case(cases[i].name, best, ret);
+  }
+}
+
+int main(void) {
+  HAL_Init();
+
+  /* Remember to wait 15ms after power up */
+  HAL_Delay(15);
+
+  dwt_init();
+  bsp_uart_init(BENCH_BAUDRATE);
+  bsp_uart_write("\nhd44780 DWT benchmark, core clock ");
+  bsp_uart_write_u32(SystemCoreClock, 0U);
+  bsp_uart_write(" Hz\n");
+
+  /* Cold init is timed once, display has just been powered up */
+  const hd44780_ctx* const lcd_ctx = hd44780_instance_ctx_get();
+  uint32_t const start = dwt_cycles();
+  hd44780_ret_e const retval = hd44780_init(lcd_ctx);
+  bench_print_case("init (cold)", dwt_cycles() - start, retval);
+
+  for (size_t i = 0U; i < (sizeof(variants) / sizeof(variants[0])); i++) {
+    bench_variant_run(&variants[i]);
+  }
+  bsp_uart_flush();
+
+  while (1) {
+    /* intentionally do nothing */
+  }
+}
+
+/* Own systick implementation due to HAL delivered delay function usage */
+void SysTick_Handler(void)
+{
+  HAL_IncTick();
+}
@@ -3,19 +3,34 @@
 #include "bsp_lcd.h"
 #include "stm32f4xx_hal.h"
 
-/* Switch between interface types - 4bit and 8bit width bus */
-#define INTERFACE_WIDTH  (4)
-//#define INTERFACE_WIDTH  (8)
-
 static void hd44780_cb_init_cotrol_pins(void);
 static void hd44780_cb_config_gpio(hd44780_gpio_dir const direction);
 static void hd44780_cb_delay_ms(uint8_t const time_ms);
+static void hd44780_cb_delay_us(uint16_t const time_us);
+static uint32_t hd44780_cb_get_time_us(void);
 static void hd44780_cb_ctrl_pin(hd44780_ctrl_pin const pin, hd44780_pin_state const state);
 static uint8_t hd44780_cb_read_bus(void);
 static void hd44780_cb_write_bus(uint8_t const data);
-static hd44780_ret_e hd44780_wait_for_busy_flag_clear(const struct hd44780_ctx_s* const ctx);
+static void hd44780_cb_write_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+static uint8_t hd44780_cb_read_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, bool nibble_mode);
+static void hd44780_cb_busy_wait_begin(const struct hd44780_ctx_s* const ctx);
+static bool hd44780_cb_busy_wait_signalled(const struct hd44780_ctx_s* const ctx, uint32_t timeout_ms);
+void EXTI9_5_IRQHandler(void);
+
+/* D7 (busy flag) pin is PB5, its falling edge is routed to EXTI line 5 */
+#define BUSY_FLAG_EXTI_LINE  (1UL << 5U)
+
+static volatile bool busy_flag_cleared;
 
-static const character_mapping mappings[3] = {
+/* BSRR value setting (upper half word resets) single pin */
+#define PIN_BSRR(pin, set)  ((set) ? (1UL << (pin)) : (1UL << ((pin) + 16U)))
+
+static void lcd_e_delay(void);
+static void lcd_e_strobe(void);
+static void lcd_bus_put(uint8_t const data);
+static uint8_t lcd_bus_get(void);
+
+const character_mapping bsp_lcd_mappings[BSP_LCD_MAPPINGS_LEN] = {
   {
       .utf_8_code = U'è',
       .character_bitmap = {0b01000, 0b00100, 0b01110, 0b10001, 0b11111, 0b10000, 0b01110, 0b00000},
@@ -51,6 +66,14 @@ static void hd44780_cb_init_cotrol_pins(void)
   HAL_GPIO_Init(GPIOC, &gpio_config);
   gpio_config.Pin = GPIO_PIN_10;
   HAL_GPIO_Init(GPIOA, &gpio_config);
+
+  /* Busy flag interrupt, falling edge on PB5, masked until wait begins */
+  __HAL_RCC_SYSCFG_CLK_ENABLE();
+  SYSCFG->EXTICR[1] = (SYSCFG->EXTICR[1] & ~SYSCFG_EXTICR2_EXTI5) | SYSCFG_EXTICR2_EXTI5_PB;
+  EXTI->IMR &= ~BUSY_FLAG_EXTI_LINE;
+  EXTI->RTSR &= ~BUSY_FLAG_EXTI_LINE;
+  EXTI->FTSR |= BUSY_FLAG_EXTI_LINE;
+  NVIC_EnableIRQ(EXTI9_5_IRQn);
 }
 
 static void hd44780_cb_config_gpio(hd44780_gpio_dir const direction) {
@@ -107,6 +130,25 @@ static void hd44780_cb_delay_ms(uint8_t const time_ms) {
   HAL_Delay(time_ms); 
 }
 
+static uint32_t hd44780_cb_get_time_us(void) {
+  /* HAL tick counts milliseconds, SysTick counter counts down within each of them */
+  uint32_t ms = 0U;
+  uint32_t val = 0U;
+  do {
+    ms = HAL_GetTick();
+    val = SysTick->VAL;
+  } while (ms != HAL_GetTick());
+  uint32_t const reload = SysTick->LOAD + 1U;
+  return (ms * 1000U) + (((reload - val) * 1000U) / reload);
+}
+
+static void hd44780_cb_delay_us(uint16_t const time_us) {
+  uint32_t const start = hd44780_cb_get_time_us();
+  while ((hd44780_cb_get_time_us() - start) < time_us) {
+    /* intentionally do nothing */
+  }
+}
+
 static void hd44780_cb_ctrl_pin(hd44780_ctrl_pin const pin, hd44780_pin_state const state) {
   GPIO_PinState const pin_state = (state == PIN_SET) ? GPIO_PIN_SET : GPIO_PIN_RESET;
   switch (pin) {
@@ -152,43 +194,137 @@ static void hd44780_cb_write_bus(uint8_t const data) {
   HAL_GPIO_WritePin(GPIOB, GPIO_PIN_5, (data & (1U << 7U)) ? GPIO_PIN_SET : GPIO_PIN_RESET);
 }
 
-static hd44780_ret_e hd44780_wait_for_busy_flag_clear(const struct hd44780_ctx_s* const ctx)
-{
+static void lcd_e_delay(void) {
+  /* Few hundreds of nanoseconds, enough for E pulse width and data setup / hold times */
+  for (volatile uint32_t i = (SystemCoreClock / 8000000U) + 1U; i > 0U; i--) {
+    /* intentionally do nothing */
+  }
+}
+
+static void lcd_e_strobe(void) {
+  GPIOA->BSRR = PIN_BSRR(10U, true);
+  lcd_e_delay();
+  GPIOA->BSRR = PIN_BSRR(10U, false);
+  lcd_e_delay();
+}
+
+static void lcd_bus_put(uint8_t const data) {
+#if (INTERFACE_WIDTH == 8)
+  GPIOA->BSRR = PIN_BSRR(15U, data & (1U << 0U));
+  GPIOC->BSRR = PIN_BSRR(11U, data & (1U << 1U));
+  GPIOD->BSRR = PIN_BSRR(0U, data & (1U << 2U)) | PIN_BSRR(2U, data & (1U << 3U)) |
+                PIN_BSRR(4U, data & (1U << 4U)) | PIN_BSRR(6U, data & (1U << 5U));
+#else
+  GPIOD->BSRR = PIN_BSRR(4U, data & (1U << 4U)) | PIN_BSRR(6U, data & (1U << 5U));
+#endif
+  GPIOB->BSRR = PIN_BSRR(7U, data & (1U << 6U)) | PIN_BSRR(5U, data & (1U << 7U));
+}
+
+static uint8_t lcd_bus_get(void) {
+  uint32_t const port_b = GPIOB->IDR;
+  uint32_t const port_d = GPIOD->IDR;
+  uint8_t data = 0U;
+#if (INTERFACE_WIDTH == 8)
+  data |= (uint8_t)(((GPIOA->IDR >> 15U) & 1U) << 0U);
+  data |= (uint8_t)(((GPIOC->IDR >> 11U) & 1U) << 1U);
+  data |= (uint8_t)(((port_d >> 0U) & 1U) << 2U);
+  data |= (uint8_t)(((port_d >> 2U) & 1U) << 3U);
+#endif
+  data |= (uint8_t)(((port_d >> 4U) & 1U) << 4U);
+  data |= (uint8_t)(((port_d >> 6U) & 1U) << 5U);
+  data |= (uint8_t)(((port_b >> 7U) & 1U) << 6U);
+  data |= (uint8_t)(((port_b >> 5U) & 1U) << 7U);
+  return data;
+}
+
+static void hd44780_cb_write_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode) {
+  /* RS and RW share port C, both set with single write */
+  GPIOC->BSRR = PIN_BSRR(9U, rs == PIN_SET) | PIN_BSRR(10U, false);
+  lcd_bus_put(data);
+  lcd_e_strobe();
+  if (nibble_mode) {
+    lcd_bus_put((uint8_t)(data << 4U));
+    lcd_e_strobe();
+  }
+}
+
+static uint8_t hd44780_cb_read_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, bool nibble_mode) {
+  GPIOC->BSRR = PIN_BSRR(9U, rs == PIN_SET) | PIN_BSRR(10U, true);
+  lcd_e_delay();
+  GPIOA->BSRR = PIN_BSRR(10U, true);
+  lcd_e_delay();
+  uint8_t data = lcd_bus_get();
+  GPIOA->BSRR = PIN_BSRR(10U, false);
+  lcd_e_delay();
+  if (nibble_mode) {
+    GPIOA->BSRR = PIN_BSRR(10U, true);
+    lcd_e_delay();
+    data |= (uint8_t)(lcd_bus_get() >> 4U);
+    GPIOA->BSRR = PIN_BSRR(10U, false);
+    lcd_e_delay();
+  }
+  return data;
+}
+
+static void hd44780_cb_busy_wait_begin(const struct hd44780_ctx_s* const ctx) {
+  busy_flag_cleared = false;
+  EXTI->PR = BUSY_FLAG_EXTI_LINE;
+  EXTI->IMR |= BUSY_FLAG_EXTI_LINE;
+}
+
+static bool hd44780_cb_busy_wait_signalled(const struct hd44780_ctx_s* const ctx, uint32_t timeout_ms) {
   /* 
-   * This is very simple implementation of wait function
-   * 
-   * If RTOS is available you can configure GPIO peripheral to trigger an interrupt
-   * when D7 busy flag pin changes state to low and wait here on semaphore locked, 
-   * then when pin changes state and interrupt triggers, in interrupt handler semaphore
-   * is released and thread unblocked
+   * There is no RTOS in this example, so core just sleeps until next interrupt.
+   * With RTOS available thread would wait here on semaphore given in interrupt handler
    */
-  hd44780_ret_e ret = HD44780_TIMEOUT;
-  int timeout_ms = HD44780_TIMEOUT_MS;
-  while ((0 <= timeout_ms)) {
-    if (!(hd44780_is_busy(ctx))) {
-      ret = HD44780_OK;
-      break;
+  uint32_t const start = HAL_GetTick();
+  while ((!busy_flag_cleared) && ((HAL_GetTick() - start) < timeout_ms)) {
+    /* Interrupt pending while masked still wakes the core, so no edge is lost */
+    __disable_irq();
+    if (!busy_flag_cleared) {
+      __WFI();
     }
-    ctx->cb_delay_ms(HD44780_TIMEOUT_TICK_MS);
-    timeout_ms -= HD44780_TIMEOUT_TICK_MS;
-  };
-  return ret;
+    __enable_irq();
+  }
+  EXTI->IMR &= ~BUSY_FLAG_EXTI_LINE;
+  return busy_flag_cleared;
+}
+
+void EXTI9_5_IRQHandler(void) {
+  if (EXTI->PR & BUSY_FLAG_EXTI_LINE) {
+    EXTI->PR = BUSY_FLAG_EXTI_LINE;
+    EXTI->IMR &= ~BUSY_FLAG_EXTI_LINE;
+    busy_flag_cleared = true;
+  }
 }
 
-hd44780_ctx * hd44780_instance_ctx_get(void) {
-  static hd44780_ctx config =
+const hd44780_ctx * hd44780_instance_ctx_get(void) {
+  static hd44780_state state;
+  static const hd44780_ctx config =
   {
     .cb_init_common = hd44780_cb_init_cotrol_pins,
     .cb_set_bus_direction = hd44780_cb_config_gpio,
     .cb_set_ctrl_pin_state = hd44780_cb_ctrl_pin,
     .cb_read_bus = hd44780_cb_read_bus,
     .cb_write_bus = hd44780_cb_write_bus,
+    .cb_write_cycle = hd44780_cb_write_cycle,
+    .cb_read_cycle = hd44780_cb_read_cycle,
     .cb_delay_ms = hd44780_cb_delay_ms,
-    .cb_wait_for_busy_flag_clear = hd44780_wait_for_busy_flag_clear,
-    .custom_chars_map = mappings,
-    .custom_chars_map_len = 3,
+    .cb_delay_us = hd44780_cb_delay_us,
+    .cb_get_time_us = hd44780_cb_get_time_us,
+    .cb_wait_for_busy_flag_clear = NULL,
+    .cb_busy_wait_begin = hd44780_cb_busy_wait_begin,
+    .cb_busy_wait_signalled = hd44780_cb_busy_wait_signalled,
+    .custom_chars_map = bsp_lcd_mappings,
+    .custom_chars_map_len = BSP_LCD_MAPPINGS_LEN,
+    .custom_chars_map_sorted = true,
+    .rom_chars_map = hd44780_rom_a00,
+    .rom_chars_map_len = HD44780_ROM_A00_LEN,
+    .state = &state,
     .number_of_lines = 4,
     .column_width = 20,
+    .fast_init = true,
+    .warm_init = true,
 #if INTERFACE_WIDTH == 4
     .interface = INTERFACE_4BIT 
 #endif
@@ -9,7 +9,21 @@
 extern "C" {
 #endif
 
-hd44780_ctx* hd44780_instance_ctx_get(void);
+/* Switch between interface types - 4bit and 8bit width bus, wiring is shared by both BSP variants */
+#ifndef INTERFACE_WIDTH
+#define INTERFACE_WIDTH  (4)
+//#define INTERFACE_WIDTH  (8)
+#endif
+
+#define BSP_LCD_MAPPINGS_LEN  (3U)
+
+extern const character_mapping bsp_lcd_mappings[BSP_LCD_MAPPINGS_LEN];
+
+/* Reference BSP, HAL GPIO driver, bsp_lcd.c */
+const hd44780_ctx* hd44780_instance_ctx_get(void);
+
+/* Register level BSP of the same wiring, bsp_lcd_fast.c */
+const hd44780_ctx* hd44780_fast_instance_ctx_get(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,264 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+/*
+ * Register level variant of bsp_lcd.c for the same wiring:
+ * - bus is written with precomputed BSRR masks, one write per port, nibble
+ *   to pins mapping is looked up instead of testing every bit
+ * - direction is switched by writing MODER of bus pins directly
+ * - bus is read with one IDR read per port
+ * - pins run at high speed
+ * No microseconds delay callback is given, so busy flag is polled back to
+ * back. Busy flag interrupt of bsp_lcd.c is not used.
+ */
+
+#include "bsp_lcd.h"
+#include "stm32f4xx_hal.h"
+
+/* BSRR value setting (upper half word resets) single pin */
+#define PIN_BSRR(pin, set)          ((set) ? (1UL << (pin)) : (1UL << ((pin) + 16U)))
+/* BSRR value of pin driven by bit of nibble */
+#define BIT_BSRR(nibble, bit, pin)  PIN_BSRR((pin), ((nibble) >> (bit)) & 1U)
+/* Table of all nibble values */
+#define LUT16(f)                    { f(0U),  f(1U),  f(2U),  f(3U),  f(4U),  f(5U),  f(6U),  f(7U), \
+                                      f(8U),  f(9U),  f(10U), f(11U), f(12U), f(13U), f(14U), f(15U) }
+
+/* Upper nibble D4 ... D7 is wired to PD4, PD6, PB7, PB5 */
+#define HIGH_PORT_D(n)  (BIT_BSRR((n), 0U, 4U) | BIT_BSRR((n), 1U, 6U))
+#define HIGH_PORT_B(n)  (BIT_BSRR((n), 2U, 7U) | BIT_BSRR((n), 3U, 5U))
+/* Lower nibble D0 ... D3 is wired to PA15, PC11, PD0, PD2 */
+#define LOW_PORT_A(n)   BIT_BSRR((n), 0U, 15U)
+#define LOW_PORT_C(n)   BIT_BSRR((n), 1U, 11U)
+#define LOW_PORT_D(n)   (BIT_BSRR((n), 2U, 0U) | BIT_BSRR((n), 3U, 2U))
+
+/* Control pins, RS and RW share port C */
+#define PIN_RS  (9U)
+#define PIN_RW  (10U)
+#define PIN_E   (10U)
+
+/* Two MODER (and OSPEEDR, PUPDR) bits per pin, MODER 01 is general purpose output */
+#define PIN_FIELD(pin, value)  ((uint32_t)(value) << ((pin) * 2U))
+#if (INTERFACE_WIDTH == 8)
+  #define BUS_PINS_A  (PIN_FIELD(15U, 1U))
+  #define BUS_PINS_C  (PIN_FIELD(11U, 1U))
+  #define BUS_PINS_D  (PIN_FIELD(0U, 1U) | PIN_FIELD(2U, 1U) | PIN_FIELD(4U, 1U) | PIN_FIELD(6U, 1U))
+#else
+  #define BUS_PINS_A  (0UL)
+  #define BUS_PINS_C  (0UL)
+  #define BUS_PINS_D  (PIN_FIELD(4U, 1U) | PIN_FIELD(6U, 1U))
+#endif
+#define BUS_PINS_B  (PIN_FIELD(5U, 1U) | PIN_FIELD(7U, 1U))
+#define CTRL_PINS_A (PIN_FIELD(PIN_E, 1U))
+#define CTRL_PINS_C (PIN_FIELD(PIN_RS, 1U) | PIN_FIELD(PIN_RW, 1U))
+
+static const uint32_t high_port_d[16] = LUT16(HIGH_PORT_D);
+static const uint32_t high_port_b[16] = LUT16(HIGH_PORT_B);
+#if (INTERFACE_WIDTH == 8)
+static const uint32_t low_port_a[16] = LUT16(LOW_PORT_A);
+static const uint32_t low_port_c[16] = LUT16(LOW_PORT_C);
+static const uint32_t low_port_d[16] = LUT16(LOW_PORT_D);
+#endif
+
+static void lcd_fast_cb_init_common(void);
+static void lcd_fast_cb_config_gpio(hd44780_gpio_dir const direction);
+static void lcd_fast_cb_delay_ms(uint8_t const time_ms);
+static uint32_t lcd_fast_cb_get_time_us(void);
+static void lcd_fast_cb_ctrl_pin(hd44780_ctrl_pin const pin, hd44780_pin_state const state);
+static uint8_t lcd_fast_cb_read_bus(void);
+static void lcd_fast_cb_write_bus(uint8_t const data);
+static void lcd_fast_cb_write_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+static uint8_t lcd_fast_cb_read_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, bool nibble_mode);
+
+static void lcd_fast_e_delay(void);
+static void lcd_fast_e_strobe(void);
+static void lcd_fast_bus_put(uint32_t const port_c, uint8_t const data);
+static uint8_t lcd_fast_bus_get(void);
+
+static void lcd_fast_cb_init_common(void) {
+  RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_GPIOBEN | RCC_AHB1ENR_GPIOCEN | RCC_AHB1ENR_GPIODEN;
+  (void)RCC->AHB1ENR;
+
+  /* E, RW low before pins become outputs, bus starts as output */
+  GPIOA->BSRR = PIN_BSRR(PIN_E, false);
+  GPIOC->BSRR = PIN_BSRR(PIN_RW, false);
+
+  /* PA15 is JTDI after reset, its pull-up is removed as well */
+  GPIOA->PUPDR &= ~((BUS_PINS_A | CTRL_PINS_A) * 3U);
+  GPIOB->PUPDR &= ~(BUS_PINS_B * 3U);
+  GPIOC->PUPDR &= ~((BUS_PINS_C | CTRL_PINS_C) * 3U);
+  GPIOD->PUPDR &= ~(BUS_PINS_D * 3U);
+  GPIOA->OSPEEDR |= (BUS_PINS_A | CTRL_PINS_A) * GPIO_SPEED_FREQ_HIGH;
+  GPIOB->OSPEEDR |= BUS_PINS_B * GPIO_SPEED_FREQ_HIGH;
+  GPIOC->OSPEEDR |= (BUS_PINS_C | CTRL_PINS_C) * GPIO_SPEED_FREQ_HIGH;
+  GPIOD->OSPEEDR |= BUS_PINS_D * GPIO_SPEED_FREQ_HIGH;
+  GPIOA->MODER = (GPIOA->MODER & ~((BUS_PINS_A | CTRL_PINS_A) * 3U)) | BUS_PINS_A | CTRL_PINS_A;
+  GPIOB->MODER = (GPIOB->MODER & ~(BUS_PINS_B * 3U)) | BUS_PINS_B;
+  GPIOC->MODER = (GPIOC->MODER & ~((BUS_PINS_C | CTRL_PINS_C) * 3U)) | BUS_PINS_C | CTRL_PINS_C;
+  GPIOD->MODER = (GPIOD->MODER & ~(BUS_PINS_D * 3U)) | BUS_PINS_D;
+}
+
+static void lcd_fast_cb_config_gpio(hd44780_gpio_dir const direction) {
+  /* Bus pins are either input (00) or output (01), so single bit of each toggles */
+  if (direction == GPIO_DIR_IN) {
+#if (INTERFACE_WIDTH == 8)
+    GPIOA->MODER &= ~BUS_PINS_A;
+    GPIOC->MODER &= ~BUS_PINS_C;
+#endif
+    GPIOD->MODER &= ~BUS_PINS_D;
+    GPIOB->MODER &= ~BUS_PINS_B;
+  } else {
+#if (INTERFACE_WIDTH == 8)
+    GPIOA->MODER |= BUS_PINS_A;
+    GPIOC->MODER |= BUS_PINS_C;
+#endif
+    GPIOD->MODER |= BUS_PINS_D;
+    GPIOB->MODER |= BUS_PINS_B;
+  }
+}
+
+static void lcd_fast_cb_delay_ms(uint8_t const time_ms) {
+  HAL_Delay(time_ms);
+}
+
+static uint32_t lcd_fast_cb_get_time_us(void) {
+  /* HAL tick counts milliseconds, SysTick counter counts down within each of them */
+  uint32_t ms = 0U;
+  uint32_t val = 0U;
+  do {
+    ms = HAL_GetTick();
+    val = SysTick->VAL;
+  } while (ms != HAL_GetTick());
+  uint32_t const reload = SysTick->LOAD + 1U;
+  return (ms * 1000U) + (((reload - val) * 1000U) / reload);
+}
+
+static void lcd_fast_cb_ctrl_pin(hd44780_ctrl_pin const pin, hd44780_pin_state const state) {
+  switch (pin) {
+    case HD44780_PIN_RS:
+      GPIOC->BSRR = PIN_BSRR(PIN_RS, state == PIN_SET);
+      break;
+    case HD44780_PIN_RW:
+      GPIOC->BSRR = PIN_BSRR(PIN_RW, state == PIN_SET);
+      break;
+    case HD44780_PIN_E:
+      GPIOA->BSRR = PIN_BSRR(PIN_E, state == PIN_SET);
+      break;
+    default:
+      break;
+  }
+}
+
+static uint8_t lcd_fast_cb_read_bus(void) {
+  return lcd_fast_bus_get();
+}
+
+static void lcd_fast_cb_write_bus(uint8_t const data) {
+  lcd_fast_bus_put(0U, data);
+}
+
+static void lcd_fast_e_delay(void) {
+  /* Few hundreds of nanoseconds, enough for E pulse width and data setup / hold times */
+  for (volatile uint32_t i = (SystemCoreClock / 8000000U) + 1U; i > 0U; i--) {
+    /* intentionally do nothing */
+  }
+}
+
+static void lcd_fast_e_strobe(void) {
+  GPIOA->BSRR = PIN_BSRR(PIN_E, true);
+  lcd_fast_e_delay();
+  GPIOA->BSRR = PIN_BSRR(PIN_E, false);
+  lcd_fast_e_delay();
+}
+
+static void lcd_fast_bus_put(uint32_t const port_c, uint8_t const data) {
+  /* Port C bits of control pins go out in the same write as bus bits */
+  uint8_t const high = (uint8_t)(data >> 4U);
+#if (INTERFACE_WIDTH == 8)
+  uint8_t const low = data & 0x0FU;
+  GPIOA->BSRR = low_port_a[low];
+  GPIOC->BSRR = port_c | low_port_c[low];
+  GPIOD->BSRR = high_port_d[high] | low_port_d[low];
+#else
+  if (0U != port_c) {
+    GPIOC->BSRR = port_c;
+  }
+  GPIOD->BSRR = high_port_d[high];
+#endif
+  GPIOB->BSRR = high_port_b[high];
+}
+
+static uint8_t lcd_fast_bus_get(void) {
+  uint32_t const port_b = GPIOB->IDR;
+  uint32_t const port_d = GPIOD->IDR;
+  /* PD4 -> D4, PD6 -> D5, PB7 -> D6, PB5 -> D7 */
+  uint32_t data = (port_d & 0x10U) | ((port_d >> 1U) & 0x20U) | ((port_b >> 1U) & 0x40U) | ((port_b << 2U) & 0x80U);
+#if (INTERFACE_WIDTH == 8)
+  /* PA15 -> D0, PC11 -> D1, PD0 -> D2, PD2 -> D3 */
+  data |= ((GPIOA->IDR >> 15U) & 0x01U) | ((GPIOC->IDR >> 10U) & 0x02U) | ((port_d << 2U) & 0x04U) |
+          ((port_d << 1U) & 0x08U);
+#endif
+  return (uint8_t)data;
+}
+
+static void lcd_fast_cb_write_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode) {
+  uint32_t const ctrl = PIN_BSRR(PIN_RS, rs == PIN_SET) | PIN_BSRR(PIN_RW, false);
+  lcd_fast_bus_put(ctrl, data);
+  lcd_fast_e_strobe();
+  if (nibble_mode) {
+    lcd_fast_bus_put(0U, (uint8_t)(data << 4U));
+    lcd_fast_e_strobe();
+  }
+}
+
+static uint8_t lcd_fast_cb_read_cycle(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, bool nibble_mode) {
+  GPIOC->BSRR = PIN_BSRR(PIN_RS, rs == PIN_SET) | PIN_BSRR(PIN_RW, true);
+  lcd_fast_e_delay();
+  GPIOA->BSRR = PIN_BSRR(PIN_E, true);
+  lcd_fast_e_delay();
+  uint8_t data = lcd_fast_bus_get();
+  GPIOA->BSRR = PIN_BSRR(PIN_E, false);
+  lcd_fast_e_delay();
+  if (nibble_mode) {
+    GPIOA->BSRR = PIN_BSRR(PIN_E, true);
+    lcd_fast_e_delay();
+    data |= (uint8_t)(lcd_fast_bus_get() >> 4U);
+    GPIOA->BSRR = PIN_BSRR(PIN_E, false);
+    lcd_fast_e_delay();
+  }
+  return data;
+}
+
+const hd44780_ctx * hd44780_fast_instance_ctx_get(void) {
+  static hd44780_state state;
+  static const hd44780_ctx config =
+  {
+    .cb_init_common = lcd_fast_cb_init_common,
+    .cb_set_bus_direction = lcd_fast_cb_config_gpio,
+    .cb_set_ctrl_pin_state = lcd_fast_cb_ctrl_pin,
+    .cb_read_bus = lcd_fast_cb_read_bus,
+    .cb_write_bus = lcd_fast_cb_write_bus,
+    .cb_write_cycle = lcd_fast_cb_write_cycle,
+    .cb_read_cycle = lcd_fast_cb_read_cycle,
+    .cb_delay_ms = lcd_fast_cb_delay_ms,
+    .cb_delay_us = NULL,
+    .cb_get_time_us = lcd_fast_cb_get_time_us,
+    .cb_wait_for_busy_flag_clear = NULL,
+    .custom_chars_map = bsp_lcd_mappings,
+    .custom_chars_map_len = BSP_LCD_MAPPINGS_LEN,
+    .custom_chars_map_sorted = true,
+    .rom_chars_map = hd44780_rom_a00,
+    .rom_chars_map_len = HD44780_ROM_A00_LEN,
+    .state = &state,
+    .number_of_lines = 4,
+    .column_width = 20,
+    .fast_init = true,
+    .warm_init = true,
+#if INTERFACE_WIDTH == 4
+    .interface = INTERFACE_4BIT
+#endif
+#if INTERFACE_WIDTH == 8
+    .interface = INTERFACE_8BIT
+#endif
+  };
+
+  return &config;
+}
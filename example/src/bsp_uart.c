@@ -0,0 +1,63 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#include "bsp_uart.h"
+#include "stm32f4xx_hal.h"
+
+/* TX pin PA2, alternate function 7 routes it to USART2 */
+#define UART_TX_PIN  (2U)
+#define UART_TX_AF   (7U)
+
+static void uart_put(char const ch);
+
+static void uart_put(char const ch) {
+  while (0U == (USART2->SR & USART_SR_TXE)) {
+    /* intentionally do nothing */
+  }
+  USART2->DR = (uint8_t)ch;
+}
+
+void bsp_uart_init(uint32_t const baudrate) {
+  RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+  RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
+  (void)RCC->APB1ENR;
+
+  GPIOA->MODER = (GPIOA->MODER & ~(3UL << (UART_TX_PIN * 2U))) | (2UL << (UART_TX_PIN * 2U));
+  GPIOA->AFR[0] = (GPIOA->AFR[0] & ~(0xFUL << (UART_TX_PIN * 4U))) | (UART_TX_AF << (UART_TX_PIN * 4U));
+
+  /* 16 times oversampling, BRR holds USARTDIV mantissa and fraction as single fixed-point value */
+  uint32_t const pclk1 = SystemCoreClock >> APBPrescTable[(RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+  USART2->CR1 = 0U;
+  USART2->BRR = (pclk1 + (baudrate / 2U)) / baudrate;
+  USART2->CR1 = USART_CR1_TE | USART_CR1_UE;
+}
+
+void bsp_uart_write(const char* text) {
+  while ('\0' != *text) {
+    if ('\n' == *text) {
+      uart_put('\r');
+    }
+    uart_put(*text++);
+  }
+}
+
+void bsp_uart_write_u32(uint32_t value, uint8_t const width) {
+  /* Right aligned in field of width characters */
+  char digits[10];
+  uint8_t len = 0U;
+  do {
+    digits[len++] = (char)('0' + (value % 10U));
+    value /= 10U;
+  } while (0U != value);
+  for (uint8_t i = len; i < width; i++) {
+    uart_put(' ');
+  }
+  while (0U < len) {
+    uart_put(digits[--len]);
+  }
+}
+
+void bsp_uart_flush(void) {
+  while (0U == (USART2->SR & USART_SR_TC)) {
+    /* intentionally do nothing */
+  }
+}
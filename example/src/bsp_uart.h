@@ -0,0 +1,22 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#ifndef __BSP_UART_H__
+#define __BSP_UART_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* USART2 transmitter on PA2 (AF7), 8N1, register level - HAL UART driver is not vendored */
+void bsp_uart_init(uint32_t const baudrate);
+void bsp_uart_write(const char* text);
+void bsp_uart_write_u32(uint32_t value, uint8_t const width);
+void bsp_uart_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_UART_H__ */
@@ -19,7 +19,7 @@ int main(void) {
   hd44780_ret_e retval = hd44780_init(lcd_ctx);
   assert(HD44780_OK == retval);
 
-  /* HD44780 can be safely initialised even if it was initialised prior */
+  /* HD44780 can be safely initialised even if it was initialised prior, warm init skips reset sequence then */
   retval = hd44780_init(lcd_ctx);
   assert(HD44780_OK == retval);
 
@@ -0,0 +1,177 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+/*
+ * Host benchmark of driver against controller model, bare-metal setup:
+ * bus cycle callbacks, microseconds timer, busy flag is polled back to back
+ * or, with microseconds delay callback, after expected execution time.
+ * Every frame changes all cells of 4x20 display, which is verified at the end.
+ * Exit code is non zero if display content is wrong or controller was
+ * written while busy.
+ */
+
+#include "hd44780.h"
+#include "hd44780_sim.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_LINES      (4U)
+#define BENCH_COLUMNS    (20U)
+#define BENCH_CELLS      (BENCH_LINES * BENCH_COLUMNS)
+#define BENCH_FRAMES     (50U)
+#define BENCH_GPIO_NS    (100U)
+
+/** @brief Benchmarked configuration */
+typedef struct {
+  const char* name;              /**< Printed name */
+  hd44780_interface interface;   /**< Bus width */
+  bool write_only;               /**< Timed writes instead of busy flag */
+  bool framebuffer;              /**< Render into framebuffer and flush */
+  bool delay_us;                 /**< Microseconds delay callback is provided */
+} bench_mode;
+
+/** @brief Benchmark result */
+typedef struct {
+  uint64_t time_ns;      /**< Time of all frames [ns] */
+  uint32_t bus_cycles;   /**< E strobes of all frames */
+  bool valid;            /**< Display shows last frame and no write was lost */
+} bench_result;
+
+static const bench_mode s_modes[] = {
+  { "8-bit busy flag direct",      INTERFACE_8BIT, false, false, false },
+  { "8-bit busy flag framebuffer", INTERFACE_8BIT, false, true,  false },
+  { "8-bit busy+delay direct",     INTERFACE_8BIT, false, false, true  },
+  { "8-bit busy+delay framebuffer",INTERFACE_8BIT, false, true,  true  },
+  { "8-bit timed     direct",      INTERFACE_8BIT, true,  false, false },
+  { "8-bit timed     framebuffer", INTERFACE_8BIT, true,  true,  false },
+  { "4-bit busy flag direct",      INTERFACE_4BIT, false, false, false },
+  { "4-bit busy flag framebuffer", INTERFACE_4BIT, false, true,  false },
+  { "4-bit busy+delay direct",     INTERFACE_4BIT, false, false, true  },
+  { "4-bit busy+delay framebuffer",INTERFACE_4BIT, false, true,  true  },
+  { "4-bit timed     direct",      INTERFACE_4BIT, true,  false, false },
+  { "4-bit timed     framebuffer", INTERFACE_4BIT, true,  true,  false },
+};
+
+/* Static, "private" functions declarations */
+
+/**
+ * @brief Get character of frame cell, consecutive frames differ in every cell
+ *
+ * @param[in] frame frame number
+ * @param[in] row row number
+ * @param[in] column column number
+ *
+ * @return character
+ */
+static char s_frame_char(uint32_t frame, uint8_t row, uint8_t column);
+
+/**
+ * @brief Draw whole frame
+ *
+ * @param[in] ctx driver context
+ * @param[in] frame frame number
+ *
+ * @return status
+ */
+static hd44780_ret_e s_draw(const hd44780_ctx* const ctx, uint32_t frame);
+
+/**
+ * @brief Initialise display in given configuration and draw frames
+ *
+ * @param[in] mode configuration
+ * @param[out] result measurement
+ */
+static void s_run(const bench_mode* const mode, bench_result* const result);
+
+/* Static functions implementation */
+
+static char s_frame_char(uint32_t frame, uint8_t row, uint8_t column) {
+  return (char)('A' + ((frame + row + column) % 26U));
+}
+
+static hd44780_ret_e s_draw(const hd44780_ctx* const ctx, uint32_t frame) {
+  hd44780_ret_e ret = HD44780_OK;
+  const bool fb = (NULL != ctx->framebuffer);
+
+  for (uint8_t row = 0U; (HD44780_OK == ret) && (row < BENCH_LINES); row++) {
+    char text[BENCH_COLUMNS + 1U];
+    for (uint8_t column = 0U; column < BENCH_COLUMNS; column++) {
+      text[column] = s_frame_char(frame, row, column);
+    }
+    text[BENCH_COLUMNS] = '\0';
+
+    ret = fb ? hd44780_fb_set_pos(ctx, row, 0U) : hd44780_set_pos(ctx, row, 0U);
+    if (HD44780_OK == ret) {
+      ret = fb ? hd44780_fb_write_text(ctx, text) : hd44780_write_text(ctx, text);
+    }
+  }
+  if (fb && (HD44780_OK == ret)) {
+    ret = hd44780_flush(ctx);
+  }
+  return ret;
+}
+
+static void s_run(const bench_mode* const mode, bench_result* const result) {
+  static hd44780_state state;
+  static uint8_t cells[BENCH_CELLS];
+  static uint8_t shadow[BENCH_CELLS];
+  static hd44780_fb fb;
+  static hd44780_sim sim;
+  hd44780_ctx ctx;
+  hd44780_ret_e ret = HD44780_OK;
+
+  memset(result, 0, sizeof(bench_result));
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&fb, 0, sizeof(fb));
+  fb.cells = cells;
+  fb.shadow = shadow;
+
+  hd44780_sim_bus_reset(BENCH_GPIO_NS);
+  hd44780_sim_reset(&sim, INTERFACE_4BIT == mode->interface, 100U);
+  hd44780_sim_bind(&ctx, &sim);
+  ctx.cb_delay_us = mode->delay_us ? hd44780_sim_delay_us : NULL;
+  ctx.state = &state;
+  ctx.framebuffer = mode->framebuffer ? &fb : NULL;
+  ctx.number_of_lines = BENCH_LINES;
+  ctx.column_width = BENCH_COLUMNS;
+  ctx.interface = mode->interface;
+  ctx.write_only = mode->write_only;
+  ctx.fast_init = true;
+
+  ret = hd44780_init(&ctx);
+  const uint64_t start_ns = hd44780_sim_shared.now_ns;
+  const uint32_t start_cycles = sim.bus_cycles;
+  for (uint32_t frame = 0U; (HD44780_OK == ret) && (frame < BENCH_FRAMES); frame++) {
+    ret = s_draw(&ctx, frame);
+  }
+  result->time_ns = hd44780_sim_shared.now_ns - start_ns;
+  result->bus_cycles = sim.bus_cycles - start_cycles;
+
+  result->valid = (HD44780_OK == ret) && (0U == sim.violations);
+  for (uint8_t row = 0U; row < BENCH_LINES; row++) {
+    for (uint8_t column = 0U; column < BENCH_COLUMNS; column++) {
+      if ((uint8_t)s_frame_char(BENCH_FRAMES - 1U, row, column) != hd44780_sim_cell(&sim, row, column, BENCH_COLUMNS)) {
+        result->valid = false;
+      }
+    }
+  }
+}
+
+int main(void) {
+  bool valid = true;
+
+  printf("%-28s %10s %12s %13s\n", "mode", "chars/s", "cycles/char", "refresh [us]");
+  for (size_t i = 0U; i < (sizeof(s_modes) / sizeof(s_modes[0])); i++) {
+    bench_result result;
+    s_run(&s_modes[i], &result);
+
+    const double chars = (double)BENCH_FRAMES * BENCH_CELLS;
+    printf("%-28s %10.0f %12.2f %13.1f%s\n", s_modes[i].name, (chars * 1e9) / (double)result.time_ns,
+           (double)result.bus_cycles / chars, ((double)result.time_ns / BENCH_FRAMES) / 1000.0,
+           result.valid ? "" : "  FAILED");
+    valid = valid && result.valid;
+  }
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+/*
+ * C++17 front end test. Encoding is checked at compile time, at runtime
+ * precomputed codes are streamed into controller model and compared with
+ * what C core writes for the same text. Exit code is number of failed checks.
+ */
+
+#include "hd44780.hpp"
+#include "hd44780_sim.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr char32_t lcd_cgram[] = { U'è', U'↑' };
+constexpr hd44780::font lcd_font(hd44780::rom_a00, lcd_cgram);
+
+/* ROM, CGRAM and ASCII characters */
+constexpr auto greeting = lcd_font.encode("Très 21°C ↑");
+static_assert(greeting.valid(), "every character is mapped");
+static_assert(11U == greeting.size(), "one code per character");
+static_assert(('T' == greeting.codes[0]) && (0U == greeting.codes[2]), "CGRAM character 0");
+static_assert(0xDFU == greeting.codes[7], "degree sign in A00 ROM");
+static_assert(1U == greeting.codes[10], "CGRAM character 1");
+
+/* Malformed sequences and unmapped characters are replaced and counted */
+constexpr auto malformed = lcd_font.encode("A\xC0\xAF" "B\xED\xA0\x80" "C\x80" "D\xE2\x82");
+static_assert(4U == malformed.unmapped, "overlong, surrogate, stray and truncated sequences");
+static_assert(8U == malformed.size(), "one code per malformed sequence");
+static_assert((HD44780_REPLACEMENT_CHAR == malformed.codes[1]) && ('D' == malformed.codes[6]) &&
+              (HD44780_REPLACEMENT_CHAR == malformed.codes[7]), "replacement character");
+constexpr auto unmapped = lcd_font.encode("5€");
+static_assert((!unmapped.valid()) && (HD44780_REPLACEMENT_CHAR == unmapped.codes[1]), "unmapped character");
+
+/* A02 ROM has European characters, CGRAM array needs one element, NUL is ASCII anyway */
+constexpr char32_t no_cgram[] = { U'\0' };
+constexpr hd44780::font eu_font(hd44780::rom_a02, no_cgram);
+static_assert(eu_font.encode("Très").valid(), "A02 maps accented letters");
+
+}  // namespace
+
+int main() {
+  static hd44780_sim sim;
+  static hd44780_state state;
+  static uint8_t ddram[2U][0x80U];
+  static const char text[] = "21°C, 5µs";
+  constexpr auto encoded = lcd_font.encode(text);
+  static_assert(encoded.valid(), "every character is mapped");
+  hd44780_ctx ctx;
+  unsigned failures = 0U;
+
+  for (int pass = 0; pass < 2; pass++) {
+    std::memset(&ctx, 0, sizeof(ctx));
+    hd44780_sim_bus_reset(100U);
+    hd44780_sim_reset(&sim, true, 100U);
+    hd44780_sim_bind(&ctx, &sim);
+    ctx.cb_delay_us = hd44780_sim_delay_us;
+    ctx.state = &state;
+    ctx.number_of_lines = 2U;
+    ctx.column_width = 16U;
+    ctx.interface = INTERFACE_4BIT;
+    ctx.fast_init = true;
+    ctx.rom_chars_map = hd44780_rom_a00;
+    ctx.rom_chars_map_len = HD44780_ROM_A00_LEN;
+    failures += (HD44780_OK != hd44780_init(&ctx)) ? 1U : 0U;
+    if (0 == pass) {
+      failures += (HD44780_OK != hd44780_set_pos(&ctx, 1U, 2U)) ? 1U : 0U;
+      failures += (HD44780_OK != hd44780_write_text(&ctx, text)) ? 1U : 0U;
+    } else {
+      failures += (HD44780_OK != hd44780::write_at(&ctx, 1U, 2U, encoded)) ? 1U : 0U;
+    }
+    failures += (0U != sim.violations) ? 1U : 0U;
+    std::memcpy(ddram[pass], sim.ddram, sizeof(sim.ddram));
+  }
+  failures += (0 != std::memcmp(ddram[0], ddram[1], sizeof(ddram[0]))) ? 1U : 0U;
+
+  std::printf("%u check(s) failed\n", failures);
+  return (0U == failures) ? 0 : 1;
+}
@@ -0,0 +1,538 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#include "hd44780_sim.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define REG_CLEAR            0x01
+#define REG_HOME             0x02
+#define REG_EM               0x04
+#define REG_EM_SHIFT_DISPLAY 0x01
+#define REG_EM_INCREMENT     0x02
+#define REG_DISPLAY_SHIFT    0x10
+#define REG_SHIFT_DISPLAY    0x08
+#define REG_SHIFT_RIGHT      0x04
+#define REG_PWR_AND_CURSOR   0x08
+#define REG_INTERFACE        0x20
+#define REG_8_BIT_BUS        0x10
+#define REG_TWO_LINES        0x08
+#define REG_CGRAM_ADDR_SET   0x40
+#define REG_DDRAM_ADDR_SET   0x80
+
+#define DDRAM_LINE_LEN       0x28
+#define DDRAM_LINE_2_START   0x40
+#define DDRAM_ONE_LINE_LEN   0x50
+#define CGRAM_ADDR_MASK      0x3F
+#define BUSY_FLAG            0x80
+#define BUS_LOW_NIBBLE       0x0F
+
+#define EXEC_CYCLE_TICKS     1U   /* RS and RW */
+#define STROBE_TICKS         3U   /* E high, bus access, E low */
+
+hd44780_sim_bus hd44780_sim_shared;
+
+/* Pin level callbacks do not take context, they drive one model at a time */
+static hd44780_sim* s_pin_sim;
+static hd44780_pin_state s_pins[3];
+static uint8_t s_pin_bus;
+static uint8_t s_pin_read;
+static bool s_pin_read_status;
+
+/* Static, "private" functions declarations */
+
+/**
+ * @brief Let time of given number of pin accesses pass
+ *
+ * @param[in] ticks number of pin accesses
+ */
+static void s_tick(uint8_t ticks);
+
+/**
+ * @brief Check whether last instruction is still executed
+ *
+ * @param[in] sim controller model
+ *
+ * @return true if busy flag is set
+ */
+static bool s_busy(const hd44780_sim* const sim);
+
+/**
+ * @brief Move address counter after data access, wraps like controller
+ *
+ * @param[in,out] sim controller model
+ * @param[in] increment direction of move
+ */
+static void s_step_address(hd44780_sim* const sim, bool increment);
+
+/**
+ * @brief Execute instruction or data write
+ *
+ * @param[in,out] sim controller model
+ * @param[in] rs RS pin state
+ * @param[in] data byte
+ */
+static void s_execute(hd44780_sim* const sim, hd44780_pin_state rs, uint8_t data);
+
+/**
+ * @brief Handle falling edge of E with RW low, any strobe reaching busy controller is violation
+ *
+ * @param[in,out] sim controller model
+ * @param[in] rs RS pin state
+ * @param[in] bus data lines driven by MCU
+ */
+static void s_strobe_write(hd44780_sim* const sim, hd44780_pin_state rs, uint8_t bus);
+
+/**
+ * @brief Handle E pulse with RW high, controller drives the bus while E is high
+ *
+ * @param[in,out] sim controller model
+ * @param[in] rs RS pin state
+ *
+ * @return bus state
+ */
+static uint8_t s_strobe_read(hd44780_sim* const sim, hd44780_pin_state rs);
+
+/**
+ * @brief Write byte or two nibbles to controllers sharing E line
+ *
+ * @param[in] sims controller models
+ * @param[in] len number of models
+ * @param[in] rs RS pin state
+ * @param[in] data byte
+ * @param[in] nibble_mode byte is sent as two nibbles
+ */
+static void s_write(hd44780_sim* const* sims, uint8_t len, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+
+/**
+ * @brief Model of cb_init_common
+ */
+static void s_init_common(void);
+
+/**
+ * @brief Model of cb_set_bus_direction
+ *
+ * @param[in] dir bus direction
+ */
+static void s_set_bus_direction(hd44780_gpio_dir dir);
+
+/**
+ * @brief Model of cb_write_cycle
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sim
+ * @param[in] rs RS pin state
+ * @param[in] data byte
+ * @param[in] nibble_mode byte is sent as two nibbles
+ */
+static void s_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+
+/**
+ * @brief Model of cb_read_cycle
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sim
+ * @param[in] rs RS pin state
+ * @param[in] nibble_mode byte is read as two nibbles
+ *
+ * @return byte read
+ */
+static uint8_t s_read_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, bool nibble_mode);
+
+/**
+ * @brief Model of cb_write_cycle of broadcast context
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sim_broadcast
+ * @param[in] rs RS pin state
+ * @param[in] data byte
+ * @param[in] nibble_mode byte is sent as two nibbles
+ */
+static void s_broadcast_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+
+/**
+ * @brief Model of cb_delay_ms
+ *
+ * @param[in] time_ms time [ms]
+ */
+static void s_delay_ms(uint8_t time_ms);
+
+/**
+ * @brief Model of cb_get_time_us
+ *
+ * @return virtual time [us]
+ */
+static uint32_t s_get_time_us(void);
+
+/**
+ * @brief Model of cb_set_ctrl_pin_state, E edges strobe model bound by hd44780_sim_bind_pins()
+ *
+ * @param[in] pin control pin
+ * @param[in] state pin state
+ */
+static void s_set_ctrl_pin_state(hd44780_ctrl_pin pin, hd44780_pin_state state);
+
+/**
+ * @brief Model of cb_read_bus, busy flag follows controller while E is high
+ *
+ * @return bus state
+ */
+static uint8_t s_read_bus(void);
+
+/**
+ * @brief Model of cb_write_bus
+ *
+ * @param[in] data data lines state
+ */
+static void s_write_bus(uint8_t data);
+
+/**
+ * @brief Model of cb_busy_wait_begin
+ *
+ * @param[in] ctx driver context
+ */
+static void s_busy_wait_begin(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Model of cb_busy_wait_signalled, D7 falling edge interrupt fires when busy flag clears
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sim
+ * @param[in] timeout_ms timeout [ms]
+ *
+ * @return true if busy flag cleared within timeout
+ */
+static bool s_busy_wait_signalled(const hd44780_ctx* const ctx, uint32_t timeout_ms);
+
+/**
+ * @brief Set callbacks common to controller and broadcast contexts
+ *
+ * @param[in,out] ctx driver context
+ */
+static void s_bind_common(hd44780_ctx* const ctx);
+
+/* Static functions implementation */
+
+static void s_tick(uint8_t ticks) {
+  hd44780_sim_shared.now_ns += (uint64_t)ticks * hd44780_sim_shared.gpio_ns;
+}
+
+static bool s_busy(const hd44780_sim* const sim) {
+  return hd44780_sim_shared.now_ns < sim->busy_until_ns;
+}
+
+static void s_step_address(hd44780_sim* const sim, bool increment) {
+  if (sim->cgram_selected) {
+    sim->address = (uint8_t)(increment ? (sim->address + 1U) : (sim->address - 1U)) & CGRAM_ADDR_MASK;
+  } else if (!sim->two_lines) {
+    sim->address = increment ? (uint8_t)((sim->address + 1U) % DDRAM_ONE_LINE_LEN) :
+                               (uint8_t)((sim->address + DDRAM_ONE_LINE_LEN - 1U) % DDRAM_ONE_LINE_LEN);
+  } else {
+    /* Two line mode, DDRAM lines are 0x00 ... 0x27 and 0x40 ... 0x67 */
+    const uint8_t line = sim->address & DDRAM_LINE_2_START;
+    const uint8_t column = (uint8_t)((sim->address & (uint8_t)(~DDRAM_LINE_2_START)) % DDRAM_LINE_LEN);
+    if (increment) {
+      sim->address = (DDRAM_LINE_LEN == (column + 1U)) ? (uint8_t)(line ^ DDRAM_LINE_2_START) : (uint8_t)(sim->address + 1U);
+    } else {
+      sim->address = (0U == column) ? (uint8_t)((line ^ DDRAM_LINE_2_START) + DDRAM_LINE_LEN - 1U) : (uint8_t)(sim->address - 1U);
+    }
+  }
+}
+
+static void s_execute(hd44780_sim* const sim, hd44780_pin_state rs, uint8_t data) {
+  uint32_t exec_ns = HD44780_SIM_EXEC_NS;
+
+  if (PIN_SET == rs) {
+    sim->data_writes++;
+    if (sim->cgram_selected) {
+      sim->cgram[sim->address & CGRAM_ADDR_MASK] = data;
+    } else {
+      sim->ddram[sim->address & 0x7FU] = data;
+      if (sim->shift_on_write) {
+        sim->display_shift = sim->increment ? (uint8_t)((sim->display_shift + 1U) % DDRAM_LINE_LEN) :
+                                              (uint8_t)((sim->display_shift + DDRAM_LINE_LEN - 1U) % DDRAM_LINE_LEN);
+      }
+    }
+    s_step_address(sim, sim->increment);
+  } else {
+    sim->instructions++;
+    if (data & REG_DDRAM_ADDR_SET) {
+      sim->address = data & (uint8_t)(~REG_DDRAM_ADDR_SET);
+      sim->cgram_selected = false;
+    } else if (data & REG_CGRAM_ADDR_SET) {
+      sim->address = data & CGRAM_ADDR_MASK;
+      sim->cgram_selected = true;
+    } else if (data & REG_INTERFACE) {
+      sim->eight_bit = (0U != (data & REG_8_BIT_BUS));
+      sim->two_lines = (0U != (data & REG_TWO_LINES));
+      sim->low_nibble = false;
+    } else if (data & REG_DISPLAY_SHIFT) {
+      if (data & REG_SHIFT_DISPLAY) {
+        sim->display_shift = (data & REG_SHIFT_RIGHT) ? (uint8_t)((sim->display_shift + DDRAM_LINE_LEN - 1U) % DDRAM_LINE_LEN) :
+                                                        (uint8_t)((sim->display_shift + 1U) % DDRAM_LINE_LEN);
+      } else {
+        s_step_address(sim, 0U != (data & REG_SHIFT_RIGHT));
+      }
+    } else if (data & REG_PWR_AND_CURSOR) {
+      sim->display_ctrl = data & 0x07U;
+    } else if (data & REG_EM) {
+      sim->increment = (0U != (data & REG_EM_INCREMENT));
+      sim->shift_on_write = (0U != (data & REG_EM_SHIFT_DISPLAY));
+    } else if (data & REG_HOME) {
+      sim->address = 0U;
+      sim->cgram_selected = false;
+      sim->display_shift = 0U;
+      exec_ns = HD44780_SIM_EXEC_LONG_NS;
+    } else if (data & REG_CLEAR) {
+      memset(sim->ddram, ' ', sizeof(sim->ddram));
+      sim->address = 0U;
+      sim->cgram_selected = false;
+      sim->display_shift = 0U;
+      sim->increment = true;
+      exec_ns = HD44780_SIM_EXEC_LONG_NS;
+    }
+  }
+  sim->busy_until_ns = hd44780_sim_shared.now_ns + (((uint64_t)exec_ns * sim->osc_scale_pct) / 100U);
+}
+
+static void s_strobe_write(hd44780_sim* const sim, hd44780_pin_state rs, uint8_t bus) {
+  bool complete = true;
+
+  if (sim->wired_4bit) {
+    bus &= (uint8_t)(~BUS_LOW_NIBBLE);
+  }
+  sim->bus_cycles++;
+  if (!sim->eight_bit) {
+    /* Upper nibble goes first, both writes and reads advance the phase */
+    complete = sim->low_nibble;
+    sim->low_nibble = !sim->low_nibble;
+  }
+
+  if (!hd44780_sim_shared.bus_output) {
+    /* Data lines float, controller latches garbage */
+    sim->violations++;
+  } else if (s_busy(sim)) {
+    /* Busy controller ignores the strobe, upper nibble included */
+    sim->violations++;
+  } else if (sim->eight_bit) {
+    s_execute(sim, rs, bus);
+  } else if (!complete) {
+    sim->high_nibble = bus & (uint8_t)(~BUS_LOW_NIBBLE);
+  } else {
+    s_execute(sim, rs, sim->high_nibble | (uint8_t)(bus >> 4U));
+  }
+}
+
+static uint8_t s_strobe_read(hd44780_sim* const sim, hd44780_pin_state rs) {
+  bool complete = true;
+  uint8_t data = 0U;
+
+  if (sim->eight_bit || !sim->low_nibble) {
+    /* Byte is latched on rising edge of E, second nibble comes from the same byte */
+    sim->read_latch = (PIN_SET == rs) ?
+                      (sim->cgram_selected ? sim->cgram[sim->address & CGRAM_ADDR_MASK] : sim->ddram[sim->address & 0x7FU]) :
+                      (uint8_t)(sim->address | (s_busy(sim) ? BUSY_FLAG : 0U));
+  }
+  data = sim->read_latch;
+  if ((!sim->eight_bit) && sim->low_nibble) {
+    data = (uint8_t)(data << 4U);
+  }
+  if (sim->wired_4bit) {
+    data &= (uint8_t)(~BUS_LOW_NIBBLE);
+  }
+  if (hd44780_sim_shared.bus_output) {
+    /* MCU and controller drive data lines at once */
+    sim->violations++;
+  }
+
+  sim->bus_cycles++;
+  if (!sim->eight_bit) {
+    complete = sim->low_nibble;
+    sim->low_nibble = !sim->low_nibble;
+  }
+  if (complete && (PIN_SET == rs)) {
+    sim->data_reads++;
+    s_step_address(sim, sim->increment);
+  }
+  return data;
+}
+
+static void s_write(hd44780_sim* const* sims, uint8_t len, hd44780_pin_state rs, uint8_t data, bool nibble_mode) {
+  s_tick(EXEC_CYCLE_TICKS);
+  for (uint8_t n = 0U; n < (nibble_mode ? 2U : 1U); n++) {
+    s_tick(STROBE_TICKS);
+    for (uint8_t i = 0U; i < len; i++) {
+      s_strobe_write(sims[i], rs, (0U == n) ? data : (uint8_t)(data << 4U));
+    }
+  }
+}
+
+static void s_init_common(void) {
+  s_tick(1U);
+}
+
+static void s_set_bus_direction(hd44780_gpio_dir dir) {
+  s_tick(1U);
+  hd44780_sim_shared.bus_output = (GPIO_DIR_OUT == dir);
+}
+
+static void s_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode) {
+  hd44780_sim* const sim = (hd44780_sim*)ctx->user_data;
+  s_write(&sim, 1U, rs, data, nibble_mode);
+}
+
+static uint8_t s_read_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, bool nibble_mode) {
+  hd44780_sim* const sim = (hd44780_sim*)ctx->user_data;
+  uint8_t data = 0U;
+
+  s_tick(EXEC_CYCLE_TICKS);
+  for (uint8_t n = 0U; n < (nibble_mode ? 2U : 1U); n++) {
+    s_tick(STROBE_TICKS);
+    const uint8_t bus = s_strobe_read(sim, rs);
+    data |= (0U == n) ? bus : (uint8_t)(bus >> 4U);
+  }
+  return data;
+}
+
+static void s_broadcast_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode) {
+  hd44780_sim_broadcast* const broadcast = (hd44780_sim_broadcast*)ctx->user_data;
+  s_write(broadcast->members, broadcast->members_len, rs, data, nibble_mode);
+}
+
+static void s_delay_ms(uint8_t time_ms) {
+  hd44780_sim_shared.now_ns += (uint64_t)time_ms * 1000000U;
+}
+
+static uint32_t s_get_time_us(void) {
+  s_tick(1U);
+  return (uint32_t)(hd44780_sim_shared.now_ns / 1000U);
+}
+
+static void s_set_ctrl_pin_state(hd44780_ctrl_pin pin, hd44780_pin_state state) {
+  const hd44780_pin_state previous = s_pins[pin];
+
+  s_tick(1U);
+  s_pins[pin] = state;
+  if ((HD44780_PIN_E != pin) || (previous == state)) {
+    return;
+  }
+  if (PIN_SET == s_pins[HD44780_PIN_RW]) {
+    if (PIN_SET == state) {
+      /* Status read starts with busy flag, first nibble in 4-bit mode */
+      s_pin_read_status = (PIN_RESET == s_pins[HD44780_PIN_RS]) && (s_pin_sim->eight_bit || !s_pin_sim->low_nibble);
+      s_pin_read = s_strobe_read(s_pin_sim, s_pins[HD44780_PIN_RS]);
+    }
+  } else if (PIN_RESET == state) {
+    s_strobe_write(s_pin_sim, s_pins[HD44780_PIN_RS], s_pin_bus);
+  }
+}
+
+static uint8_t s_read_bus(void) {
+  s_tick(1U);
+  if (s_pin_read_status && (PIN_SET == s_pins[HD44780_PIN_E])) {
+    s_pin_read = (uint8_t)((s_pin_read & (uint8_t)(~BUSY_FLAG)) | (s_busy(s_pin_sim) ? BUSY_FLAG : 0U));
+  }
+  return s_pin_read;
+}
+
+static void s_write_bus(uint8_t data) {
+  s_tick(1U);
+  s_pin_bus = data;
+}
+
+static void s_busy_wait_begin(const hd44780_ctx* const ctx) {
+  (void)ctx;
+  s_tick(1U);
+}
+
+static bool s_busy_wait_signalled(const hd44780_ctx* const ctx, uint32_t timeout_ms) {
+  const hd44780_sim* const sim = (const hd44780_sim*)ctx->user_data;
+  const uint64_t timeout_ns = (uint64_t)timeout_ms * 1000000U;
+  bool signalled = true;
+
+  if (s_busy(sim)) {
+    if ((sim->busy_until_ns - hd44780_sim_shared.now_ns) > timeout_ns) {
+      hd44780_sim_shared.now_ns += timeout_ns;
+      signalled = false;
+    } else {
+      hd44780_sim_shared.now_ns = sim->busy_until_ns;
+    }
+  }
+  return signalled;
+}
+
+static void s_bind_common(hd44780_ctx* const ctx) {
+  ctx->cb_init_common = s_init_common;
+  ctx->cb_set_bus_direction = s_set_bus_direction;
+  ctx->cb_set_ctrl_pin_state = NULL;
+  ctx->cb_read_bus = NULL;
+  ctx->cb_write_bus = NULL;
+  ctx->cb_busy_wait_begin = NULL;
+  ctx->cb_busy_wait_signalled = NULL;
+  ctx->cb_delay_ms = s_delay_ms;
+  ctx->cb_get_time_us = s_get_time_us;
+}
+
+/* "Public" functions implementation */
+
+void hd44780_sim_bus_reset(uint16_t gpio_ns) {
+  memset(&hd44780_sim_shared, 0, sizeof(hd44780_sim_shared));
+  hd44780_sim_shared.gpio_ns = gpio_ns;
+}
+
+void hd44780_sim_reset(hd44780_sim* const sim, bool wired_4bit, uint16_t osc_scale_pct) {
+  memset(sim, 0, sizeof(hd44780_sim));
+  memset(sim->ddram, ' ', sizeof(sim->ddram));
+  sim->increment = true;
+  sim->eight_bit = true;
+  sim->wired_4bit = wired_4bit;
+  sim->osc_scale_pct = osc_scale_pct;
+}
+
+void hd44780_sim_bind(hd44780_ctx* const ctx, hd44780_sim* const sim) {
+  s_bind_common(ctx);
+  ctx->cb_write_cycle = s_write_cycle;
+  ctx->cb_read_cycle = s_read_cycle;
+  ctx->user_data = sim;
+}
+
+void hd44780_sim_bind_pins(hd44780_ctx* const ctx, hd44780_sim* const sim) {
+  s_bind_common(ctx);
+  ctx->cb_write_cycle = NULL;
+  ctx->cb_read_cycle = NULL;
+  ctx->cb_set_ctrl_pin_state = s_set_ctrl_pin_state;
+  ctx->cb_read_bus = s_read_bus;
+  ctx->cb_write_bus = s_write_bus;
+  ctx->cb_busy_wait_begin = s_busy_wait_begin;
+  ctx->cb_busy_wait_signalled = s_busy_wait_signalled;
+  ctx->user_data = sim;
+  s_pin_sim = sim;
+  memset(s_pins, 0, sizeof(s_pins));
+  s_pin_bus = 0U;
+  s_pin_read = 0U;
+  s_pin_read_status = false;
+}
+
+void hd44780_sim_bind_broadcast(hd44780_ctx* const ctx, hd44780_sim_broadcast* const broadcast) {
+  s_bind_common(ctx);
+  ctx->cb_write_cycle = s_broadcast_write_cycle;
+  ctx->cb_read_cycle = NULL;
+  ctx->user_data = broadcast;
+}
+
+void hd44780_sim_port_write(hd44780_sim* const sim, uint32_t elapsed_ns, hd44780_pin_state rs, hd44780_pin_state e, uint8_t bus) {
+  const bool falling = sim->port_e && (PIN_RESET == e);
+
+  hd44780_sim_shared.now_ns += elapsed_ns;
+  hd44780_sim_shared.bus_output = true;
+  sim->port_e = (PIN_SET == e);
+  if (falling) {
+    s_strobe_write(sim, rs, bus);
+  }
+}
+
+void hd44780_sim_delay_us(uint16_t time_us) {
+  hd44780_sim_shared.now_ns += (uint64_t)time_us * 1000U;
+}
+
+uint8_t hd44780_sim_cell(const hd44780_sim* const sim, uint8_t row, uint8_t column, uint8_t column_width) {
+  const uint8_t line = (row & 1U) ? DDRAM_LINE_2_START : 0U;
+  const uint8_t offset = (row & 2U) ? column_width : 0U;
+  return sim->ddram[line + ((offset + column + sim->display_shift) % DDRAM_LINE_LEN)];
+}
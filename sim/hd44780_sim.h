@@ -0,0 +1,179 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#ifndef __HD44780_SIM__H__
+#define __HD44780_SIM__H__
+
+#include "hd44780.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Host model of HD44780 controllers behind regular driver callbacks. Each model
+ * keeps DDRAM, CGRAM, address counter, busy flag with datasheet execution times
+ * and nibble phase of 4-bit interface, starting in 8-bit mode as after power on.
+ *
+ * Model is bound to driver context through user_data and cycle callbacks, so
+ * several controllers (bus group, dual controller display) can be simulated at
+ * once. Broadcast context strobes every controller of its list. Per pin callbacks
+ * (E, RS, RW, bus, interrupt driven busy wait) do not take context, so model bound
+ * with them is the only one driven that way at a time.
+ *
+ * Time and bus direction are shared by all models (one MCU, one data bus), as
+ * timer, delay and direction callbacks do not take context. Time is virtual: it
+ * advances by gpio_ns with each pin access or timer read and by requested delays,
+ * so results do not depend on host speed. Write strobe (byte or single nibble)
+ * reaching controller while it is busy or while MCU does not drive the bus, and
+ * read while MCU drives the bus, are ignored and counted as violations:
+ *
+ *   hd44780_sim_bus_reset(100U);
+ *   hd44780_sim_reset(&lcd_sim, false, 100U);
+ *   hd44780_sim_bind(&ctx, &lcd_sim);
+ *   hd44780_init(&ctx);
+ */
+
+/** @brief Execution time of most instructions and data writes at nominal oscillator [ns] */
+#define HD44780_SIM_EXEC_NS         (37000U)
+/** @brief Execution time of clear display and return home at nominal oscillator [ns] */
+#define HD44780_SIM_EXEC_LONG_NS    (1520000U)
+/** @brief Maximum number of controllers strobed by broadcast context */
+#define HD44780_SIM_BROADCAST_MAX   (8U)
+
+/** @brief Controller model, read only for application */
+typedef struct {
+  /* Controller */
+  uint8_t ddram[0x80U];        /**< Display data RAM, indexed by address */
+  uint8_t cgram[64U];          /**< Character generator RAM */
+  uint8_t address;             /**< Address counter */
+  bool cgram_selected;         /**< Address counter points to CGRAM */
+  bool increment;              /**< Entry mode increment */
+  bool shift_on_write;         /**< Entry mode display shift */
+  uint8_t display_shift;       /**< DDRAM column shown in leftmost display column */
+  uint8_t display_ctrl;        /**< Display, cursor and blink bits */
+  bool eight_bit;              /**< Interface data length */
+  bool two_lines;              /**< Number of display lines */
+  bool low_nibble;             /**< 4-bit interface, next strobe transfers lower nibble */
+  uint8_t high_nibble;         /**< 4-bit interface, latched upper nibble of write */
+  uint8_t read_latch;          /**< Byte being read */
+  uint64_t busy_until_ns;      /**< End of execution of last instruction [ns] */
+  /* Wiring */
+  bool wired_4bit;             /**< Only D4 ... D7 are connected */
+  uint16_t osc_scale_pct;      /**< Execution times scale, 100 for nominal 270kHz oscillator [%] */
+  bool port_e;                 /**< E state set by hd44780_sim_port_write() */
+  /* Statistics */
+  uint32_t bus_cycles;         /**< E strobes */
+  uint32_t instructions;       /**< Executed instructions */
+  uint32_t data_writes;        /**< Executed data writes */
+  uint32_t data_reads;         /**< Data register reads */
+  uint32_t violations;         /**< Bus cycles ignored, controller busy or bus driven wrong way */
+} hd44780_sim;
+
+/** @brief Controllers strobed at once by broadcast context, pointed by its user_data */
+typedef struct {
+  hd44780_sim* members[HD44780_SIM_BROADCAST_MAX];   /**< Controllers */
+  uint8_t members_len;                               /**< Number of controllers */
+} hd44780_sim_broadcast;
+
+/** @brief State shared by all models - MCU side of the bus, read only for application */
+typedef struct {
+  uint64_t now_ns;             /**< Virtual time [ns] */
+  uint16_t gpio_ns;            /**< Time of one pin access or timer read [ns] */
+  bool bus_output;             /**< MCU drives data lines */
+} hd44780_sim_bus;
+
+/** @brief Shared state of models */
+extern hd44780_sim_bus hd44780_sim_shared;
+
+/**
+ * @brief Reset virtual time, data lines are MCU inputs as after reset
+ *
+ * @param[in] gpio_ns time taken by each pin access or timer read [ns]
+ */
+void hd44780_sim_bus_reset(uint16_t gpio_ns);
+
+/**
+ * @brief Power on controller, DDRAM is filled with spaces, interface is 8-bit
+ *
+ * @param[out] sim controller model
+ * @param[in] wired_4bit only D4 ... D7 are connected, D0 ... D3 read as low
+ * @param[in] osc_scale_pct execution times scale, e.g. 150 for slow display [%]
+ */
+void hd44780_sim_reset(hd44780_sim* const sim, bool wired_4bit, uint16_t osc_scale_pct);
+
+/**
+ * @brief Fill context callbacks with model callbacks
+ *
+ * @details Cycle callbacks, bus direction, millisecond delay and microseconds timer
+ *          are set and user_data points model. Pin level and interrupt driven busy
+ *          wait callbacks are cleared, microseconds delay and cb_wait_for_busy_flag_clear
+ *          are left as they are
+ *
+ * @param[in,out] ctx driver context
+ * @param[in] sim controller model
+ */
+void hd44780_sim_bind(hd44780_ctx* const ctx, hd44780_sim* const sim);
+
+/**
+ * @brief Fill context callbacks with per pin callbacks driving model, instead of cycle ones
+ *
+ * @details As hd44780_sim_bind(), but cycle callbacks are cleared and pin, bus and
+ *          interrupt driven busy wait callbacks are set. Previously pin bound model
+ *          is not driven any more
+ *
+ * @param[in,out] ctx driver context
+ * @param[in] sim controller model
+ */
+void hd44780_sim_bind_pins(hd44780_ctx* const ctx, hd44780_sim* const sim);
+
+/**
+ * @brief Fill context callbacks of broadcast context, writes reach every listed controller
+ *
+ * @details As hd44780_sim_bind(), context has to be write only
+ *
+ * @param[in,out] ctx driver context
+ * @param[in] broadcast controllers
+ */
+void hd44780_sim_bind_broadcast(hd44780_ctx* const ctx, hd44780_sim_broadcast* const broadcast);
+
+/**
+ * @brief Set outputs of port expander or shift register driving write only controller
+ *
+ * @details Outputs drive data lines, RW is low. Virtual time advances by elapsed_ns
+ *          first (e.g. bus time of port write), falling edge of E strobes write
+ *
+ * @param[in,out] sim controller model
+ * @param[in] elapsed_ns time since previous output change [ns]
+ * @param[in] rs RS pin state
+ * @param[in] e E pin state
+ * @param[in] bus D4 ... D7 on bits 4 ... 7 (D0 ... D7 in 8-bit wiring)
+ */
+void hd44780_sim_port_write(hd44780_sim* const sim, uint32_t elapsed_ns, hd44780_pin_state rs, hd44780_pin_state e, uint8_t bus);
+
+/**
+ * @brief Microseconds delay callback, optional for context
+ *
+ * @param[in] time_us time [us]
+ */
+void hd44780_sim_delay_us(uint16_t time_us);
+
+/**
+ * @brief Get character shown in display cell, display shift included
+ *
+ * @param[in] sim controller model
+ * @param[in] row row number
+ * @param[in] column column number
+ * @param[in] column_width width of display row
+ *
+ * @return DDRAM byte
+ */
+uint8_t hd44780_sim_cell(const hd44780_sim* const sim, uint8_t row, uint8_t column, uint8_t column_width);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HD44780_SIM__H__ */
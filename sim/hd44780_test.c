@@ -0,0 +1,938 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+/*
+ * Host regression test of driver against controller models. Every case checks
+ * what controllers ended up with (DDRAM, CGRAM) against framebuffer or expected
+ * text and that no bus cycle reached a busy controller or undriven bus.
+ * Single display cases run through cycle callbacks and again through per pin
+ * callbacks. Exit code is number of failed checks.
+ */
+
+#include "hd44780.h"
+#include "hd44780_dual.h"
+#include "hd44780_pcf8574.h"
+#include "hd44780_sr595.h"
+#include "hd44780_sim.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_LINES       (4U)
+#define TEST_COLUMNS     (20U)
+#define TEST_CELLS       (TEST_LINES * TEST_COLUMNS)
+#define TEST_GPIO_NS     (100U)
+#define TEST_GLYPHS      (10U)
+#define TEST_GLYPH_BASE  (0xE000UL)
+#define TEST_I2C_ADDR    (0x27U)
+#define TEST_QUEUE_LEN   (256U)
+#define TEST_TICK_US     (10U)
+
+#define CHECK(cond) s_check((cond), #cond, __func__, __LINE__)
+
+/** @brief Display under test - context with its own model, state and framebuffer */
+typedef struct {
+  hd44780_ctx ctx;                 /**< Driver context */
+  hd44780_sim sim;                 /**< Controller model */
+  hd44780_state state;             /**< Driver state */
+  hd44780_fb fb;                   /**< Framebuffer */
+  uint8_t cells[TEST_CELLS];       /**< Framebuffer cells */
+  uint8_t shadow[TEST_CELLS];      /**< Framebuffer shadow */
+} test_lcd;
+
+static unsigned s_failures;
+static bool s_pin_level;
+static uint8_t s_done_tag;
+static hd44780_sim* s_port_sim;
+static uint32_t s_port_clock_ns;
+static character_mapping s_glyphs[TEST_GLYPHS];
+
+/* Static, "private" functions declarations */
+
+/**
+ * @brief Count and report failed check
+ *
+ * @param[in] ok check result
+ * @param[in] expr checked expression
+ * @param[in] func test case
+ * @param[in] line source line
+ */
+static void s_check(bool ok, const char* expr, const char* func, int line);
+
+/**
+ * @brief Power on model and prepare context of 4-bit display
+ *
+ * @param[out] lcd display under test
+ * @param[in] lines number of lines
+ * @param[in] columns column width
+ * @param[in] write_only timed writes instead of busy flag
+ * @param[in] framebuffer use framebuffer
+ */
+static void s_lcd_setup(test_lcd* const lcd, uint8_t lines, uint8_t columns, bool write_only, bool framebuffer);
+
+/**
+ * @brief Check that controller shows framebuffer cells and shadow matches them
+ *
+ * @param[in] lcd display under test
+ *
+ * @return true if display matches
+ */
+static bool s_lcd_shows_fb(const test_lcd* const lcd);
+
+/**
+ * @brief Check that display row starts with given text
+ *
+ * @param[in] lcd display under test
+ * @param[in] row row number
+ * @param[in] text expected ASCII text
+ *
+ * @return true if row matches
+ */
+static bool s_lcd_row_is(const test_lcd* const lcd, uint8_t row, const char* text);
+
+/**
+ * @brief Check that display cell shows given custom glyph
+ *
+ * @param[in] lcd display under test
+ * @param[in] row row number
+ * @param[in] column column number
+ * @param[in] glyph index in s_glyphs
+ *
+ * @return true if cell code points CGRAM character holding glyph bitmap
+ */
+static bool s_lcd_cell_is_glyph(const test_lcd* const lcd, uint8_t row, uint8_t column, uint8_t glyph);
+
+/**
+ * @brief Run hd44780_tick() every TEST_TICK_US until queue is executed
+ *
+ * @param[in,out] lcd display under test, asynchronous mode
+ * @param[in] max_us time limit [us]
+ *
+ * @return true if queue got empty in time and every tick succeeded
+ */
+static bool s_lcd_drain(test_lcd* const lcd, uint32_t max_us);
+
+/**
+ * @brief Run hd44780_tick() every TEST_TICK_US for given time
+ *
+ * @param[in,out] lcd display under test, asynchronous mode
+ * @param[in] time_us time [us]
+ *
+ * @return true if every tick succeeded
+ */
+static bool s_lcd_tick_for(test_lcd* const lcd, uint32_t time_us);
+
+/**
+ * @brief Notification callback, stores tag in s_done_tag
+ *
+ * @param[in] ctx driver context
+ * @param[in] tag notification tag
+ */
+static void s_async_done(const hd44780_ctx* const ctx, uint8_t tag);
+
+/**
+ * @brief Encode custom glyph as UTF-8
+ *
+ * @param[out] out buffer, at least 4 bytes
+ * @param[in] glyph index in s_glyphs
+ */
+static void s_glyph_utf8(char* const out, uint8_t glyph);
+
+/**
+ * @brief I2C write of PCF8574 transport, port bytes are decoded into s_port_sim
+ *
+ * @param[in] address 7 bit I2C address
+ * @param[in] data port bytes
+ * @param[in] len number of bytes
+ */
+static void s_i2c_write(uint8_t address, const uint8_t* data, size_t len);
+
+/**
+ * @brief Transfer of 74HC595 transport, frames are decoded into s_port_sim
+ *
+ * @details Transfer is decoded at once and completed before return, as if
+ *          CPU slept until DMA is done
+ *
+ * @param[in] sr transport
+ * @param[in] data frames
+ * @param[in] len number of frames
+ * @param[in] done_cb completion callback
+ */
+static void s_spi_transfer(hd44780_sr595* const sr, const uint8_t* data, size_t len, hd44780_sr595_done_cb done_cb);
+
+static void s_test_partial_update(void);
+static void s_test_glyph_cache(void);
+static void s_test_frames_glyph_cache(void);
+static void s_test_printf_at(void);
+static void s_test_utf8_invalid(void);
+static void s_test_smart_clear(void);
+static void s_test_cmd_ring(void);
+static void s_test_scrub(void);
+static void s_test_recover_shifted(void);
+static void s_test_marquee(void);
+static void s_test_async_queue(void);
+static void s_test_anim(void);
+static void s_test_group_broadcast(void);
+static void s_test_dual(void);
+static void s_test_pcf8574(void);
+static void s_test_sr595(void);
+
+/* Static functions implementation */
+
+static void s_check(bool ok, const char* expr, const char* func, int line) {
+  if (!ok) {
+    printf("%s:%d (%s): check failed: %s\n", func, line, s_pin_level ? "pins" : "cycles", expr);
+    s_failures++;
+  }
+}
+
+static void s_lcd_setup(test_lcd* const lcd, uint8_t lines, uint8_t columns, bool write_only, bool framebuffer) {
+  memset(lcd, 0, sizeof(test_lcd));
+  hd44780_sim_reset(&lcd->sim, true, 100U);
+  if (s_pin_level) {
+    hd44780_sim_bind_pins(&lcd->ctx, &lcd->sim);
+  } else {
+    hd44780_sim_bind(&lcd->ctx, &lcd->sim);
+  }
+  lcd->fb.cells = lcd->cells;
+  lcd->fb.shadow = lcd->shadow;
+  lcd->ctx.cb_delay_us = hd44780_sim_delay_us;
+  lcd->ctx.state = &lcd->state;
+  lcd->ctx.framebuffer = framebuffer ? &lcd->fb : NULL;
+  lcd->ctx.number_of_lines = lines;
+  lcd->ctx.column_width = columns;
+  lcd->ctx.interface = INTERFACE_4BIT;
+  lcd->ctx.write_only = write_only;
+  lcd->ctx.fast_init = true;
+}
+
+static bool s_lcd_shows_fb(const test_lcd* const lcd) {
+  const uint8_t columns = lcd->ctx.column_width;
+  bool ok = true;
+  for (uint8_t row = 0U; row < lcd->ctx.number_of_lines; row++) {
+    for (uint8_t column = 0U; column < columns; column++) {
+      const uint16_t i = ((uint16_t)row * columns) + column;
+      ok = ok && (lcd->fb.cells[i] == hd44780_sim_cell(&lcd->sim, row, column, columns)) &&
+           (lcd->fb.cells[i] == lcd->fb.shadow[i]);
+    }
+  }
+  return ok;
+}
+
+static bool s_lcd_row_is(const test_lcd* const lcd, uint8_t row, const char* text) {
+  bool ok = true;
+  for (uint8_t column = 0U; ok && ('\0' != text[column]); column++) {
+    ok = ((uint8_t)text[column] == hd44780_sim_cell(&lcd->sim, row, column, lcd->ctx.column_width));
+  }
+  return ok;
+}
+
+static bool s_lcd_cell_is_glyph(const test_lcd* const lcd, uint8_t row, uint8_t column, uint8_t glyph) {
+  const uint8_t code = hd44780_sim_cell(&lcd->sim, row, column, lcd->ctx.column_width);
+  bool ok = (code < 16U);
+  for (uint8_t i = 0U; ok && (i < 8U); i++) {
+    ok = (lcd->sim.cgram[((code % 8U) * 8U) + i] == s_glyphs[glyph].character_bitmap[i]);
+  }
+  return ok;
+}
+
+static bool s_lcd_drain(test_lcd* const lcd, uint32_t max_us) {
+  bool ok = true;
+  for (uint32_t elapsed_us = 0U; ok && (!hd44780_async_idle(&lcd->ctx)) && (elapsed_us <= max_us); elapsed_us += TEST_TICK_US) {
+    ok = (HD44780_OK == hd44780_tick(&lcd->ctx));
+    hd44780_sim_delay_us(TEST_TICK_US);
+  }
+  return ok && hd44780_async_idle(&lcd->ctx);
+}
+
+static bool s_lcd_tick_for(test_lcd* const lcd, uint32_t time_us) {
+  bool ok = true;
+  for (uint32_t elapsed_us = 0U; ok && (elapsed_us < time_us); elapsed_us += TEST_TICK_US) {
+    ok = (HD44780_OK == hd44780_tick(&lcd->ctx));
+    hd44780_sim_delay_us(TEST_TICK_US);
+  }
+  return ok;
+}
+
+static void s_async_done(const hd44780_ctx* const ctx, uint8_t tag) {
+  (void)ctx;
+  s_done_tag = tag;
+}
+
+static void s_glyph_utf8(char* const out, uint8_t glyph) {
+  const uint32_t codepoint = TEST_GLYPH_BASE + glyph;
+  out[0] = (char)(0xE0U | (codepoint >> 12U));
+  out[1] = (char)(0x80U | ((codepoint >> 6U) & 0x3FU));
+  out[2] = (char)(0x80U | (codepoint & 0x3FU));
+  out[3] = '\0';
+}
+
+static void s_i2c_write(uint8_t address, const uint8_t* data, size_t len) {
+  /* Start condition and address byte, port follows acknowledge of every byte */
+  uint32_t elapsed_ns = 10U * s_port_clock_ns;
+
+  CHECK(TEST_I2C_ADDR == address);
+  for (size_t i = 0U; i < len; i++) {
+    elapsed_ns += 9U * s_port_clock_ns;
+    hd44780_sim_port_write(s_port_sim, elapsed_ns, (data[i] & 0x01U) ? PIN_SET : PIN_RESET,
+                           (data[i] & 0x04U) ? PIN_SET : PIN_RESET, data[i] & 0xF0U);
+    elapsed_ns = 0U;
+  }
+  /* Stop condition */
+  hd44780_sim_port_write(s_port_sim, s_port_clock_ns, PIN_RESET, PIN_RESET, 0U);
+}
+
+static void s_spi_transfer(hd44780_sr595* const sr, const uint8_t* data, size_t len, hd44780_sr595_done_cb done_cb) {
+  /* Outputs are latched after every 8 clocks frame */
+  for (size_t i = 0U; i < len; i++) {
+    hd44780_sim_port_write(s_port_sim, 8U * s_port_clock_ns, (data[i] & 0x01U) ? PIN_SET : PIN_RESET,
+                           (data[i] & 0x02U) ? PIN_SET : PIN_RESET, data[i] & 0xF0U);
+  }
+  done_cb(sr);
+}
+
+static void s_test_partial_update(void) {
+  static test_lcd lcd;
+
+  for (uint8_t mode = 0U; mode < 2U; mode++) {
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, (1U == mode), true);
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+    for (uint8_t row = 0U; row < TEST_LINES; row++) {
+      CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, row, 0U));
+      CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, "abcdefghijklmnopqrst"));
+    }
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    CHECK(s_lcd_shows_fb(&lcd));
+
+    /* Changes with gaps, in the middle of row, at row ends and across row order */
+    const uint32_t writes = lcd.sim.data_writes;
+    const uint8_t changes[][2] = { { 0U, 3U }, { 0U, 10U }, { 0U, 11U }, { 2U, 19U }, { 1U, 0U }, { 3U, 0U } };
+    for (size_t i = 0U; i < (sizeof(changes) / sizeof(changes[0])); i++) {
+      CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, changes[i][0], changes[i][1]));
+      CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, "#"));
+    }
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    CHECK(s_lcd_shows_fb(&lcd));
+    CHECK((sizeof(changes) / sizeof(changes[0])) == (lcd.sim.data_writes - writes));
+
+    /* Direct write moves address counter, following flush has to set it again */
+    CHECK(HD44780_OK == hd44780_set_pos(&lcd.ctx, 3U, 5U));
+    CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 0U, 4U));
+    CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, "%"));
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    CHECK(s_lcd_shows_fb(&lcd));
+    CHECK(0U == lcd.sim.violations);
+  }
+}
+
+static void s_test_glyph_cache(void) {
+  static test_lcd lcd;
+  char text[TEST_GLYPHS * 4U];
+
+  hd44780_sim_bus_reset(TEST_GPIO_NS);
+  s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, false, true);
+  lcd.ctx.custom_chars_map = s_glyphs;
+  lcd.ctx.custom_chars_map_len = TEST_GLYPHS;
+  lcd.ctx.custom_chars_map_sorted = true;
+  CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+
+  /* Fills CGRAM */
+  text[0] = '\0';
+  for (uint8_t g = 0U; g < 8U; g++) {
+    s_glyph_utf8(&text[strlen(text)], g);
+  }
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 0U, 0U));
+  CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, text));
+  CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+
+  /* Every character is on screen, no slot can be taken */
+  s_glyph_utf8(text, 8U);
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 1U, 0U));
+  CHECK(HD44780_CGRAM_FULL == hd44780_fb_write_text(&lcd.ctx, text));
+
+  /* Two of them leave the screen, new ones evict them */
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 0U, 2U));
+  CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, "  "));
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 1U, 0U));
+  CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, " "));
+  CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+  s_glyph_utf8(text, 8U);
+  s_glyph_utf8(&text[3], 9U);
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 3U, 18U));
+  CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, text));
+  CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+
+  CHECK(s_lcd_shows_fb(&lcd));
+  for (uint8_t g = 0U; g < 8U; g++) {
+    CHECK(((2U == g) || (3U == g)) || s_lcd_cell_is_glyph(&lcd, 0U, g, g));
+  }
+  CHECK(s_lcd_cell_is_glyph(&lcd, 3U, 18U, 8U));
+  CHECK(s_lcd_cell_is_glyph(&lcd, 3U, 19U, 9U));
+  CHECK(0U == lcd.sim.violations);
+}
+
+static void s_test_frames_glyph_cache(void) {
+  static test_lcd lcd;
+  static uint8_t frames[3][TEST_CELLS];
+
+  /* Render task must not load CGRAM, so glyph cache is rejected */
+  hd44780_sim_bus_reset(TEST_GPIO_NS);
+  s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, false, true);
+  lcd.fb.cells = NULL;
+  for (uint8_t f = 0U; f < 3U; f++) {
+    lcd.fb.frames[f] = frames[f];
+  }
+  lcd.ctx.custom_chars_map = s_glyphs;
+  lcd.ctx.custom_chars_map_len = TEST_GLYPHS;
+  CHECK(HD44780_INV_ARG == hd44780_init(&lcd.ctx));
+
+  /* Fixed CGRAM assignment renders without bus access */
+  lcd.ctx.custom_chars_map_len = 8U;
+  CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+  const uint32_t cycles = lcd.sim.bus_cycles;
+  char text[4];
+  s_glyph_utf8(text, 5U);
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 1U, 1U));
+  CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, text));
+  CHECK(HD44780_OK == hd44780_fb_publish(&lcd.ctx));
+  CHECK(cycles == lcd.sim.bus_cycles);
+  CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+  CHECK(s_lcd_cell_is_glyph(&lcd, 1U, 1U, 5U));
+  CHECK(0U == lcd.sim.violations);
+}
+
+static void s_test_printf_at(void) {
+  static test_lcd lcd;
+
+  hd44780_sim_bus_reset(TEST_GPIO_NS);
+  s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, false, true);
+  CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 0U, 0U, "T%5.1d%-3s|%03u", 215, "C", 7U));
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 1U, 2U, "%x %c%%", 0xBEEFU, 'z'));
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 2U, 0U, "%s|%.2s|", (const char*)NULL, (const char*)NULL));
+  /* Width is saturated at row width, numbers above 255 are rejected instead of wrapping around */
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 3U, 0U, "%255d", 5));
+  CHECK(HD44780_INV_ARG == hd44780_printf_at(&lcd.ctx, 3U, 0U, "%300d", 5));
+  CHECK(HD44780_INV_ARG == hd44780_printf_at(&lcd.ctx, 3U, 0U, "%99999999999d", 5));
+  CHECK(HD44780_INV_ARG == hd44780_printf_at(&lcd.ctx, 3U, 0U, "%.256s", "x"));
+  CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+  CHECK(s_lcd_row_is(&lcd, 0U, "T 21.5C  |007"));
+  CHECK(s_lcd_row_is(&lcd, 1U, "  beef z%"));
+  CHECK(s_lcd_row_is(&lcd, 2U, "(null)|(n|"));
+  CHECK(s_lcd_row_is(&lcd, 3U, "                   5"));
+  CHECK(s_lcd_shows_fb(&lcd));
+  CHECK(0U == lcd.sim.violations);
+}
+
+static void s_test_utf8_invalid(void) {
+  static test_lcd lcd;
+  /* Overlong, truncated, stray continuations, surrogate, above U+10FFFF, invalid lead, truncated at end */
+  static const char text[] = "A\xC0\xAF" "B\xE2\x82" "C\x80\x80" "D\xED\xA0\x80" "E\xF4\x90\x80\x80" "F\xF8" "G\xE2";
+  static const char expected[] = "A?B?C??D?E?F?G?";
+  char shown[sizeof(expected)];
+
+  for (size_t i = 0U; i < sizeof(expected); i++) {
+    shown[i] = ('?' == expected[i]) ? (char)HD44780_REPLACEMENT_CHAR : expected[i];
+  }
+  for (uint8_t mode = 0U; mode < 2U; mode++) {
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, false, (1U == mode));
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+    if (0U == mode) {
+      CHECK(HD44780_OK == hd44780_set_pos(&lcd.ctx, 1U, 0U));
+      CHECK(HD44780_OK == hd44780_write_text(&lcd.ctx, text));
+    } else {
+      CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 1U, 0U));
+      CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, text));
+      CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+      CHECK(s_lcd_shows_fb(&lcd));
+    }
+    CHECK(s_lcd_row_is(&lcd, 1U, shown));
+    CHECK(' ' == hd44780_sim_cell(&lcd.sim, 1U, (uint8_t)strlen(shown), TEST_COLUMNS));
+    CHECK(0U == lcd.sim.violations);
+  }
+}
+
+static void s_test_smart_clear(void) {
+  static test_lcd lcd;
+  static const char spaces[] = "                    ";
+
+  hd44780_sim_bus_reset(TEST_GPIO_NS);
+  s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, false, true);
+  lcd.ctx.smart_clear = true;
+  CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+
+  /* Two runs in DDRAM address order, four in row order - only the former is cheaper than Clear Display */
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 0U, 10U, "0123456789"));
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 2U, 0U, "0123456789"));
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 1U, 10U, "0123456789"));
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 3U, 0U, "01234567"));
+  CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+  const uint32_t instructions = lcd.sim.instructions;
+  const uint32_t writes = lcd.sim.data_writes;
+  CHECK(HD44780_OK == hd44780_clear(&lcd.ctx));
+  CHECK(3U == (lcd.sim.instructions - instructions));
+  CHECK(38U == (lcd.sim.data_writes - writes));
+  for (uint8_t row = 0U; row < TEST_LINES; row++) {
+    CHECK(s_lcd_row_is(&lcd, row, spaces));
+  }
+  CHECK(0U == lcd.sim.address);
+  CHECK(0U == lcd.sim.violations);
+}
+
+static void s_test_cmd_ring(void) {
+  static test_lcd lcd;
+  static hd44780_cmd_ring ring;
+
+  for (uint8_t mode = 0U; mode < 2U; mode++) {
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, false, (1U == mode));
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+    hd44780_cmd_ring_init(&ring);
+    CHECK(HD44780_OK == hd44780_cmd_post_text(&ring, 0U, 0U, "first"));
+    CHECK(HD44780_OK == hd44780_cmd_post_clear(&ring));
+    CHECK(HD44780_OK == hd44780_cmd_post_text(&ring, 2U, 3U, "second"));
+    CHECK(HD44780_OK == hd44780_cmd_post_text(&ring, 3U, 0U, "third"));
+    CHECK(HD44780_OK == hd44780_cmd_process(&lcd.ctx, &ring));
+    CHECK(s_lcd_row_is(&lcd, 0U, "     "));
+    CHECK(s_lcd_row_is(&lcd, 2U, "   second"));
+    CHECK(s_lcd_row_is(&lcd, 3U, "third"));
+    CHECK((0U == mode) || s_lcd_shows_fb(&lcd));
+    CHECK(0U == lcd.sim.violations);
+  }
+}
+
+static void s_test_scrub(void) {
+  static test_lcd lcd;
+
+  hd44780_sim_bus_reset(TEST_GPIO_NS);
+  s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, false, true);
+  CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+  CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 1U, 0U, "scrubbed row"));
+  CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+
+  /* Upset of display RAM, not seen by driver */
+  lcd.sim.ddram[0x40U + 3U] = '!';
+  for (uint8_t n = 0U; n <= TEST_LINES; n++) {
+    CHECK(HD44780_OK == hd44780_scrub(&lcd.ctx));
+  }
+  CHECK(s_lcd_shows_fb(&lcd));
+  CHECK(1U == lcd.state.scrub_repairs);
+  CHECK(0U == lcd.sim.violations);
+}
+
+static void s_test_recover_shifted(void) {
+  static test_lcd lcd;
+
+  for (uint8_t mode = 0U; mode < 2U; mode++) {
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, 2U, 16U, (1U == mode), false);
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+    CHECK(HD44780_OK == hd44780_write_text(&lcd.ctx, "0123456789"));
+    CHECK(HD44780_OK == hd44780_scroll(&lcd.ctx, 3));
+
+    /* Lost nibble, upper half latched by controller is zero - first reset instruction completes return home */
+    lcd.sim.low_nibble = true;
+    lcd.sim.high_nibble = 0x00U;
+    CHECK(HD44780_OK == hd44780_recover(&lcd.ctx));
+    CHECK(3U == lcd.state.display_shift);
+    CHECK(3U == lcd.sim.display_shift);
+    CHECK(s_lcd_row_is(&lcd, 0U, "3456789"));
+
+    /* Scrolled text lands where driver expects it */
+    CHECK(HD44780_OK == hd44780_set_pos(&lcd.ctx, 1U, 13U));
+    CHECK(HD44780_OK == hd44780_write_text(&lcd.ctx, "xyz"));
+    CHECK(HD44780_OK == hd44780_scroll(&lcd.ctx, -3));
+    CHECK(s_lcd_row_is(&lcd, 0U, "0123456789"));
+    CHECK(s_lcd_row_is(&lcd, 1U, "             xyz"));
+    CHECK(0U == lcd.sim.violations);
+  }
+}
+
+static void s_test_marquee(void) {
+  static test_lcd lcd;
+  /* Shorter than row is repeated, longer than DDRAM line is streamed, display as wide as DDRAM line */
+  static const struct {
+    uint8_t columns;
+    const char* text;
+  } cases[] = {
+    { 16U, "abc" },
+    { 16U, "The quick brown fox jumps over the lazy dog, twice. " },
+    { 40U, "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-*/=#" },
+  };
+
+  for (uint8_t mode = 0U; mode < 2U; mode++) {
+    for (size_t c = 0U; c < (sizeof(cases) / sizeof(cases[0])); c++) {
+      const size_t len = strlen(cases[c].text);
+      hd44780_marquee marquee = { .text = cases[c].text, .row = 1U };
+      char expected[41];
+
+      hd44780_sim_bus_reset(TEST_GPIO_NS);
+      s_lcd_setup(&lcd, 2U, cases[c].columns, (1U == mode), false);
+      CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+      CHECK(HD44780_OK == hd44780_scroll(&lcd.ctx, 5));
+      CHECK(HD44780_OK == hd44780_marquee_start(&lcd.ctx, &marquee));
+      CHECK(0U == lcd.sim.display_shift);
+
+      /* More than twice around DDRAM line, display window wraps from column 39 to 0 */
+      for (uint16_t step = 0U; step <= 100U; step++) {
+        for (uint8_t column = 0U; column < cases[c].columns; column++) {
+          expected[column] = cases[c].text[(step + column) % len];
+        }
+        expected[cases[c].columns] = '\0';
+        CHECK(s_lcd_row_is(&lcd, 1U, expected));
+        CHECK((step % 40U) == lcd.sim.display_shift);
+        CHECK(HD44780_OK == hd44780_marquee_step(&lcd.ctx, &marquee));
+      }
+      CHECK(0U == lcd.sim.violations);
+    }
+  }
+}
+
+static void s_test_async_queue(void) {
+  static test_lcd lcd;
+  static hd44780_op queue[TEST_QUEUE_LEN];
+
+  for (uint8_t mode = 0U; mode < 2U; mode++) {
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, (1U == mode), true);
+    lcd.ctx.queue = queue;
+    lcd.ctx.queue_len = TEST_QUEUE_LEN;
+    lcd.ctx.cb_async_done = s_async_done;
+    s_done_tag = 0U;
+
+    /* Init is only queued, delays and execution times are waited by ticks */
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+    CHECK(!hd44780_async_idle(&lcd.ctx));
+    CHECK(0U == lcd.sim.instructions);
+    CHECK(s_lcd_drain(&lcd, 100000U));
+
+    CHECK(HD44780_OK == hd44780_set_pos(&lcd.ctx, 1U, 3U));
+    CHECK(HD44780_OK == hd44780_write_text(&lcd.ctx, "queued"));
+    CHECK(HD44780_OK == hd44780_async_notify(&lcd.ctx, 7U));
+    CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, 2U, 0U, "ticks %u", 42U));
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    CHECK(0U == s_done_tag);
+    CHECK(s_lcd_drain(&lcd, 100000U));
+    CHECK(7U == s_done_tag);
+    CHECK(s_lcd_row_is(&lcd, 1U, "   queued"));
+    CHECK(s_lcd_row_is(&lcd, 2U, "ticks 42"));
+
+    /* One element is kept free, operations queued before it got full are executed */
+    uint16_t queued = 0U;
+    while ((queued < TEST_QUEUE_LEN) && (HD44780_OK == hd44780_async_notify(&lcd.ctx, (uint8_t)queued))) {
+      queued++;
+    }
+    CHECK((TEST_QUEUE_LEN - 1U) == queued);
+    CHECK(HD44780_QUEUE_FULL == hd44780_async_notify(&lcd.ctx, 0U));
+    CHECK(s_lcd_drain(&lcd, 100000U));
+    CHECK((uint8_t)(queued - 1U) == s_done_tag);
+    CHECK(0U == lcd.sim.violations);
+  }
+}
+
+static void s_test_anim(void) {
+  static test_lcd lcd;
+  static hd44780_op queue[TEST_QUEUE_LEN];
+  static const character_mapping frames[2] = {
+    { .character_bitmap = { 0x1FU, 0x00U, 0x1FU, 0x00U, 0x1FU, 0x00U, 0x1FU, 0x00U } },
+    { .character_bitmap = { 0x00U, 0x1FU, 0x00U, 0x1FU, 0x00U, 0x1FU, 0x00U, 0x1FU } },
+  };
+  static const uint8_t code = 2U;
+  const uint8_t* const cgram = &lcd.sim.cgram[code * 8U];
+
+  for (uint8_t mode = 0U; mode < 2U; mode++) {
+    hd44780_anim anim = { .frames = frames, .frames_len = 2U, .index = code, .period_ms = 20U };
+
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, 2U, 16U, (1U == mode), true);
+    lcd.ctx.queue = queue;
+    lcd.ctx.queue_len = TEST_QUEUE_LEN;
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+    CHECK(s_lcd_drain(&lcd, 100000U));
+    CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 0U, 0U));
+    CHECK(HD44780_OK == hd44780_fb_write_raw(&lcd.ctx, &code, 1U));
+    CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, " spinner"));
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    CHECK(s_lcd_drain(&lcd, 100000U));
+
+    /* First frame is written while queue is empty, address is given back afterwards */
+    CHECK(HD44780_OK == hd44780_anim_start(&lcd.ctx, &anim));
+    CHECK(s_lcd_tick_for(&lcd, 1000U));
+    CHECK(0 == memcmp(cgram, frames[0].character_bitmap, 8U));
+    CHECK(0U == lcd.state.anim_return);
+    CHECK(!lcd.sim.cgram_selected);
+
+    /* Second frame is interrupted by queued flush and then by stop, halfway through its rows */
+    for (uint32_t elapsed_us = 0U; ((1U != anim.frame) || (anim.row < 4U)) && (elapsed_us < 30000U); elapsed_us += TEST_TICK_US) {
+      CHECK(HD44780_OK == hd44780_tick(&lcd.ctx));
+      hd44780_sim_delay_us(TEST_TICK_US);
+    }
+    CHECK((1U == anim.frame) && (4U == anim.row));
+    CHECK(0U != lcd.state.anim_return);
+    CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd.ctx, 1U, 0U));
+    CHECK(HD44780_OK == hd44780_fb_write_text(&lcd.ctx, "queued"));
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    hd44780_anim_stop(&lcd.ctx, &anim);
+    CHECK(s_lcd_drain(&lcd, 100000U));
+    CHECK(0U == lcd.state.anim_return);
+
+    /* Nothing is sent any more, tracked CGRAM holds rows written before stop, row 4 was being written */
+    const uint32_t bus_cycles = lcd.sim.bus_cycles;
+    CHECK(s_lcd_tick_for(&lcd, 50000U));
+    CHECK(bus_cycles == lcd.sim.bus_cycles);
+    CHECK(0 == memcmp(cgram, &lcd.state.cgram[code * 8U], 8U));
+    CHECK(0 == memcmp(cgram, frames[1].character_bitmap, 4U));
+    CHECK(0 == memcmp(&cgram[5], &frames[0].character_bitmap[5], 3U));
+    CHECK(code == hd44780_sim_cell(&lcd.sim, 0U, 0U, 16U));
+    CHECK(s_lcd_row_is(&lcd, 1U, "queued"));
+    CHECK(s_lcd_shows_fb(&lcd));
+    CHECK(0U == lcd.sim.violations);
+  }
+}
+
+static void s_test_group_broadcast(void) {
+  static test_lcd lcd[2];
+  static hd44780_ctx bc_ctx;
+  static hd44780_state bc_state;
+  static hd44780_sim_broadcast bc_sims;
+  const hd44780_ctx* const members[2] = { &lcd[0].ctx, &lcd[1].ctx };
+  const hd44780_group group = { .members = members, .members_len = 2U, .broadcast = &bc_ctx };
+
+  hd44780_sim_bus_reset(TEST_GPIO_NS);
+  for (uint8_t m = 0U; m < 2U; m++) {
+    /* Members read busy flag, so they leave shared bus as input */
+    s_lcd_setup(&lcd[m], TEST_LINES, TEST_COLUMNS, false, true);
+    bc_sims.members[m] = &lcd[m].sim;
+  }
+  bc_sims.members_len = 2U;
+  bc_ctx = lcd[0].ctx;
+  bc_ctx.state = &bc_state;
+  bc_ctx.framebuffer = NULL;
+  bc_ctx.write_only = true;
+  hd44780_sim_bind_broadcast(&bc_ctx, &bc_sims);
+  CHECK(HD44780_OK == hd44780_group_init(&group));
+
+  /* Equal text is broadcast */
+  for (uint8_t m = 0U; m < 2U; m++) {
+    CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd[m].ctx, 0U, 0U));
+    CHECK(HD44780_OK == hd44780_fb_write_text(&lcd[m].ctx, "HELLO"));
+  }
+  CHECK(HD44780_OK == hd44780_group_flush(&group));
+
+  /* Member specific text moves address counters away from broadcast one */
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd[0].ctx, 1U, 0U));
+  CHECK(HD44780_OK == hd44780_fb_write_text(&lcd[0].ctx, "left"));
+  CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd[1].ctx, 2U, 7U));
+  CHECK(HD44780_OK == hd44780_fb_write_text(&lcd[1].ctx, "right"));
+  CHECK(HD44780_OK == hd44780_group_flush(&group));
+
+  /* Broadcast right after where previous broadcast ended */
+  for (uint8_t m = 0U; m < 2U; m++) {
+    CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd[m].ctx, 0U, 5U));
+    CHECK(HD44780_OK == hd44780_fb_write_text(&lcd[m].ctx, "!"));
+  }
+  CHECK(HD44780_OK == hd44780_group_flush(&group));
+
+  /* Direct write and clear of one member between flushes */
+  CHECK(HD44780_OK == hd44780_set_pos(&lcd[1].ctx, 3U, 0U));
+  CHECK(HD44780_OK == hd44780_write_text(&lcd[1].ctx, "x"));
+  CHECK(HD44780_OK == hd44780_set_pos(&lcd[1].ctx, 3U, 0U));
+  CHECK(HD44780_OK == hd44780_write_text(&lcd[1].ctx, " "));
+  for (uint8_t m = 0U; m < 2U; m++) {
+    CHECK(HD44780_OK == hd44780_fb_set_pos(&lcd[m].ctx, 0U, 6U));
+    CHECK(HD44780_OK == hd44780_fb_write_text(&lcd[m].ctx, "?"));
+  }
+  CHECK(HD44780_OK == hd44780_group_flush(&group));
+
+  for (uint8_t m = 0U; m < 2U; m++) {
+    CHECK(s_lcd_shows_fb(&lcd[m]));
+    CHECK(s_lcd_row_is(&lcd[m], 0U, "HELLO!?"));
+    CHECK(0U == lcd[m].sim.violations);
+  }
+  CHECK(s_lcd_row_is(&lcd[0], 1U, "left"));
+  CHECK(s_lcd_row_is(&lcd[1], 2U, "       right"));
+}
+
+static void s_test_dual(void) {
+  static test_lcd half[2];
+  static hd44780_ctx bc_ctx;
+  static hd44780_state bc_state;
+  static hd44780_sim_broadcast bc_sims;
+  static uint8_t cells[4U * 40U];
+  static uint8_t shadow[4U * 40U];
+  static hd44780_dual dual;
+
+  hd44780_sim_bus_reset(TEST_GPIO_NS);
+  for (uint8_t h = 0U; h < 2U; h++) {
+    s_lcd_setup(&half[h], HD44780_DUAL_HALF_ROWS, 40U, false, true);
+    half[h].fb.cells = &cells[h * 2U * 40U];
+    half[h].fb.shadow = &shadow[h * 2U * 40U];
+    bc_sims.members[h] = &half[h].sim;
+  }
+  bc_sims.members_len = 2U;
+  bc_ctx = half[0].ctx;
+  bc_ctx.state = &bc_state;
+  bc_ctx.framebuffer = NULL;
+  bc_ctx.write_only = true;
+  hd44780_sim_bind_broadcast(&bc_ctx, &bc_sims);
+  memset(&dual, 0, sizeof(dual));
+  dual.half[0] = &half[0].ctx;
+  dual.half[1] = &half[1].ctx;
+  dual.broadcast = &bc_ctx;
+  CHECK(HD44780_OK == hd44780_dual_init(&dual));
+
+  for (uint8_t row = 0U; row < 4U; row++) {
+    CHECK(HD44780_OK == hd44780_dual_fb_set_pos(&dual, row, 0U));
+    CHECK(HD44780_OK == hd44780_dual_fb_write_text(&dual, "same on every row"));
+    CHECK(HD44780_OK == hd44780_dual_fb_set_pos(&dual, row, 30U));
+    CHECK(HD44780_OK == hd44780_dual_fb_write_text(&dual, (row < 2U) ? "upper" : "lower"));
+  }
+  CHECK(HD44780_OK == hd44780_dual_flush(&dual));
+
+  /* Clear leaves both controllers busy, framebuffers are rewritten afterwards */
+  CHECK(HD44780_OK == hd44780_dual_clear(&dual));
+  CHECK(HD44780_OK == hd44780_dual_fb_clear(&dual));
+  CHECK(HD44780_OK == hd44780_dual_set_pos(&dual, 3U, 0U));
+  CHECK(HD44780_OK == hd44780_dual_fb_set_pos(&dual, 0U, 0U));
+  CHECK(HD44780_OK == hd44780_dual_fb_write_text(&dual, "after clear"));
+  CHECK(HD44780_OK == hd44780_dual_fb_set_pos(&dual, 2U, 0U));
+  CHECK(HD44780_OK == hd44780_dual_fb_write_text(&dual, "after clear"));
+  CHECK(HD44780_OK == hd44780_dual_flush(&dual));
+
+  for (uint8_t h = 0U; h < 2U; h++) {
+    CHECK(s_lcd_shows_fb(&half[h]));
+    CHECK(s_lcd_row_is(&half[h], 0U, "after clear"));
+    CHECK(0U == half[h].sim.violations);
+  }
+}
+
+static void s_test_pcf8574(void) {
+  static test_lcd lcd;
+  static uint8_t buf[32];
+  /* I2C clock, pad bytes, execution times are kept */
+  static const struct {
+    uint32_t hz;
+    uint8_t pad;
+    bool kept;
+  } clocks[] = {
+    { 100000U, HD44780_PCF8574_PAD_BYTES(100000U, HD44780_EXEC_TIME_SCALE_PCT), true },
+    { 400000U, HD44780_PCF8574_PAD_BYTES(400000U, HD44780_EXEC_TIME_SCALE_PCT), true },
+    { 1000000U, HD44780_PCF8574_PAD_BYTES(1000000U, HD44780_EXEC_TIME_SCALE_PCT), true },
+    { 400000U, 0U, false },
+  };
+
+  for (size_t c = 0U; c < (sizeof(clocks) / sizeof(clocks[0])); c++) {
+    hd44780_pcf8574 pcf = HD44780_PCF8574_DEFAULT(TEST_I2C_ADDR, buf, clocks[c].pad, s_i2c_write);
+
+    /* Display as slow as driver assumes by default */
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, true, true);
+    hd44780_sim_reset(&lcd.sim, true, HD44780_EXEC_TIME_SCALE_PCT);
+    lcd.ctx.cb_set_bus_direction = NULL;
+    lcd.ctx.cb_write_cycle = hd44780_pcf8574_write_cycle;
+    lcd.ctx.cb_read_cycle = NULL;
+    lcd.ctx.cb_write_data_run = hd44780_pcf8574_write_data_run;
+    lcd.ctx.user_data = &pcf;
+    s_port_sim = &lcd.sim;
+    s_port_clock_ns = 1000000000UL / clocks[c].hz;
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+
+    /* Direct run spans several transfers, whole framebuffer is written over it */
+    CHECK(HD44780_OK == hd44780_set_pos(&lcd.ctx, 0U, 0U));
+    CHECK(HD44780_OK == hd44780_write_text(&lcd.ctx, "port expander string"));
+    CHECK(clocks[c].kept == s_lcd_row_is(&lcd, 0U, "port expander string"));
+    for (uint8_t row = 0U; row < TEST_LINES; row++) {
+      CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, row, 0U, "row %u at %8ukHz", row, (unsigned)(clocks[c].hz / 1000U)));
+    }
+    CHECK(HD44780_OK == hd44780_fb_invalidate(&lcd.ctx));
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    CHECK(clocks[c].kept == s_lcd_shows_fb(&lcd));
+    CHECK(clocks[c].kept == (0U == lcd.sim.violations));
+  }
+}
+
+static void s_test_sr595(void) {
+  static test_lcd lcd;
+  static uint8_t buf[512];
+  /* SPI clock, hold frames, execution times are kept */
+  static const struct {
+    uint32_t hz;
+    uint8_t hold;
+    bool kept;
+  } clocks[] = {
+    { 250000U, HD44780_SR595_HOLD_FRAMES(250000U, HD44780_EXEC_TIME_SCALE_PCT), true },
+    { 1000000U, HD44780_SR595_HOLD_FRAMES(1000000U, HD44780_EXEC_TIME_SCALE_PCT), true },
+    { 4000000U, HD44780_SR595_HOLD_FRAMES(4000000U, HD44780_EXEC_TIME_SCALE_PCT), true },
+    { 1000000U, 3U, false },
+  };
+
+  for (size_t c = 0U; c < (sizeof(clocks) / sizeof(clocks[0])); c++) {
+    hd44780_sr595 sr = HD44780_SR595_DEFAULT(buf, clocks[c].hold, s_spi_transfer);
+
+    /* Display as slow as driver assumes by default */
+    hd44780_sim_bus_reset(TEST_GPIO_NS);
+    s_lcd_setup(&lcd, TEST_LINES, TEST_COLUMNS, true, true);
+    hd44780_sim_reset(&lcd.sim, true, HD44780_EXEC_TIME_SCALE_PCT);
+    lcd.ctx.cb_set_bus_direction = NULL;
+    lcd.ctx.cb_write_cycle = hd44780_sr595_write_cycle;
+    lcd.ctx.cb_read_cycle = NULL;
+    lcd.ctx.cb_write_data_run = hd44780_sr595_write_data_run;
+    lcd.ctx.cb_flush_begin = hd44780_sr595_flush_begin;
+    lcd.ctx.cb_flush_end = hd44780_sr595_flush_end;
+    lcd.ctx.user_data = &sr;
+    s_port_sim = &lcd.sim;
+    s_port_clock_ns = 1000000000UL / clocks[c].hz;
+    CHECK(HD44780_OK == hd44780_init(&lcd.ctx));
+
+    /* Direct run is sent right away, flush is collected into one transfer */
+    CHECK(HD44780_OK == hd44780_set_pos(&lcd.ctx, 0U, 0U));
+    CHECK(HD44780_OK == hd44780_write_text(&lcd.ctx, "shift register text"));
+    CHECK(clocks[c].kept == s_lcd_row_is(&lcd, 0U, "shift register text"));
+    for (uint8_t row = 0U; row < TEST_LINES; row++) {
+      CHECK(HD44780_OK == hd44780_printf_at(&lcd.ctx, row, 0U, "row %u at %8ukHz", row, (unsigned)(clocks[c].hz / 1000U)));
+    }
+    CHECK(HD44780_OK == hd44780_fb_invalidate(&lcd.ctx));
+    CHECK(HD44780_OK == hd44780_flush(&lcd.ctx));
+    /* Write following flush waits for transfer and keeps execution time of its last byte */
+    CHECK(HD44780_OK == hd44780_set_pos(&lcd.ctx, 3U, 0U));
+    CHECK(clocks[c].kept == s_lcd_shows_fb(&lcd));
+    CHECK(clocks[c].kept == (0U == lcd.sim.violations));
+  }
+}
+
+int main(void) {
+  for (uint8_t g = 0U; g < TEST_GLYPHS; g++) {
+    s_glyphs[g].utf_8_code = TEST_GLYPH_BASE + g;
+    for (uint8_t i = 0U; i < 8U; i++) {
+      s_glyphs[g].character_bitmap[i] = (uint8_t)((g + i) & 0x1FU);
+    }
+  }
+
+  for (uint8_t pass = 0U; pass < 2U; pass++) {
+    s_pin_level = (1U == pass);
+    s_test_partial_update();
+    s_test_glyph_cache();
+    s_test_frames_glyph_cache();
+    s_test_printf_at();
+    s_test_utf8_invalid();
+    s_test_smart_clear();
+    s_test_cmd_ring();
+    s_test_scrub();
+    s_test_recover_shifted();
+    s_test_marquee();
+    s_test_async_queue();
+    s_test_anim();
+  }
+  /* Models sharing the bus are driven through cycle callbacks taking context */
+  s_pin_level = false;
+  s_test_group_broadcast();
+  s_test_dual();
+  s_test_pcf8574();
+  s_test_sr595();
+
+  printf("%u check(s) failed\n", s_failures);
+  return (0U == s_failures) ? 0 : 1;
+}
@@ -2,18 +2,31 @@
 
 #include "hd44780.h"
 
+#include <stdarg.h>
 #include <stdint.h>
 #include <string.h>
 
+#ifdef HD44780_BSP_HEADER
+  #include HD44780_BSP_HEADER
+#endif
+
 /* "Private" macrodefinitions */
 #define REG_CLEAR            0x01
 
+#define REG_HOME             0x02
+
 #define REG_EM               0x04
 #define REG_EM_SHIFT_CURSOR  0x00
 #define REG_EM_SHIFT_DISPLAY 0x01
 #define REG_EM_DECREMENT     0x00
 #define REG_EM_INCREMENT     0x02
 
+#define REG_DISPLAY_SHIFT    0x10
+#define REG_SHIFT_CURSOR     0x00
+#define REG_SHIFT_DISPLAY    0x08
+#define REG_SHIFT_LEFT       0x00
+#define REG_SHIFT_RIGHT      0x04
+
 #define REG_PWR_AND_CURSOR   0x08
 #define REG_CURSOR_NOBLINK   0x00
 #define REG_CURSOR_BLINK     0x01
@@ -34,11 +47,109 @@
 
 #define REG_DDRAM_ADDR_SET   0x80
 
+#define DDRAM_LINE_LEN       0x28
+#define DDRAM_LINE_2_START   0x40
+#define CGRAM_ADDR_MASK      0x3F
+#define CGRAM_CHARS          8U
+#define GLYPH_NONE           0xFFFFU
+#define UTF8_INVALID         0xFFFFFFFFUL
+
+#define EXEC_TIME_US         37U
+#define EXEC_TIME_LONG_US    1520U
+
+#define OP_INSTRUCTION       0x00
+#define OP_DATA              0x01
+#define OP_NIBBLE            0x02
+#define OP_DELAY             0x03
+#define OP_NOTIFY            0x04
+
+#define CMD_TEXT             0x00
+#define CMD_CLEAR            0x01
+#define CMD_CURSOR           0x02
+
+#define RING_MASK            (HD44780_CMD_RING_LEN - 1U)
+#define RING_LOAD(p)         __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RING_STORE(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#define FB_BLANK             ' '
+#define FB_SWAP_INIT         0x24  /* Back frame 0, ready frame 1, front frame 2 */
+#define FB_SWAP_FRESH        0x40
+#define FB_SWAP_BACK(s)      ((s) & 0x03U)
+#define FB_SWAP_READY(s)     (((s) >> 2U) & 0x03U)
+#define FB_SWAP_FRONT(s)     (((s) >> 4U) & 0x03U)
+#define FB_SWAP(b, r, f)     ((uint8_t)((b) | ((r) << 2U) | ((f) << 4U)))
+#define HAS_FRAMES(fb)       (NULL != (fb)->frames[0])
+
+#define ANIM_STEP_NONE       0x00
+#define ANIM_STEP_ADDRESS    0x01
+#define ANIM_STEP_ROW        0x02
+#define ANIM_STEP_RETURN     0x03
+
+#define FMT_LEFT             0x01
+#define FMT_ZERO             0x02
+#define FMT_UPPER            0x04
+#define FMT_NO_PRECISION     0xFF
+#define FMT_MAX_DECIMALS     9U
+#define WARM_PROBE_ADDR      0x46
+#define ADDR_UNKNOWN         0xFF
+#define BUS_DIR_UNKNOWN      0xFF
+
+/* Build time specialisation, resolved to constants when fixed */
+#if defined(HD44780_FIXED_INTERFACE_4BIT)
+  #define IS_4BIT(ctx)         (true)
+#elif defined(HD44780_FIXED_INTERFACE_8BIT)
+  #define IS_4BIT(ctx)         (false)
+#else
+  #define IS_4BIT(ctx)         (INTERFACE_4BIT == (ctx)->interface)
+#endif
+
+#if defined(HD44780_FIXED_WRITE_ONLY)
+  #define IS_WRITE_ONLY(ctx)   (0 != HD44780_FIXED_WRITE_ONLY)
+#else
+  #define IS_WRITE_ONLY(ctx)   ((ctx)->write_only)
+#endif
+
+#if defined(HD44780_NO_ASYNC)
+  #define HAS_QUEUE(ctx)       (false)
+#else
+  #define HAS_QUEUE(ctx)       (NULL != (ctx)->queue)
+#endif
+
+#if defined(HD44780_BSP_WRITE_CYCLE)
+  #define HAS_WRITE_CYCLE(ctx)                 (true)
+  #define WRITE_CYCLE(ctx, rs, data, nibbles)  HD44780_BSP_WRITE_CYCLE((ctx), (rs), (data), (nibbles))
+#else
+  #define HAS_WRITE_CYCLE(ctx)                 (NULL != (ctx)->cb_write_cycle)
+  #define WRITE_CYCLE(ctx, rs, data, nibbles)  (ctx)->cb_write_cycle((ctx), (rs), (data), (nibbles))
+#endif
+
+#if defined(HD44780_BSP_READ_CYCLE)
+  #define HAS_READ_CYCLE(ctx)                  (true)
+  #define READ_CYCLE(ctx, rs, nibbles)         HD44780_BSP_READ_CYCLE((ctx), (rs), (nibbles))
+#else
+  #define HAS_READ_CYCLE(ctx)                  (NULL != (ctx)->cb_read_cycle)
+  #define READ_CYCLE(ctx, rs, nibbles)         (ctx)->cb_read_cycle((ctx), (rs), (nibbles))
+#endif
+
+#if HD44780_STATS
+  #define STATS_ADD(ctx, counter, n)           ((ctx)->state->stats.counter += (n))
+  #define STATS_SUB(ctx, counter, n)           ((ctx)->state->stats.counter -= (n))
+  #define STATS_TIME_US(ctx)                   ((NULL != (ctx)->cb_get_time_us) ? (ctx)->cb_get_time_us() : 0U)
+  #define TRACE(ctx, kind, data, len)          s_trace((ctx), (kind), (data), (len))
+#else
+  #define STATS_ADD(ctx, counter, n)           ((void)(n))
+  #define STATS_SUB(ctx, counter, n)           ((void)(n))
+  #define STATS_TIME_US(ctx)                   (0U)
+  #define TRACE(ctx, kind, data, len)          ((void)(data))
+#endif
+
 /* Static, "private" functions declarations */
 
 /**
  * @brief Prepare the bus for data read
  *
+ * @details Callbacks are called only if bus is not configured already
+ *
  * @param[in] ctx driver context
  */
 static void s_config_bus_as_input(const hd44780_ctx* const ctx);
@@ -46,10 +157,87 @@ static void s_config_bus_as_input(const hd44780_ctx* const ctx);
 /**
  * @brief Prepare the bus for data write
  *
+ * @details Callbacks are called only if bus is not configured already
+ *
  * @param[in] ctx driver context
  */
 static void s_config_bus_as_output(const hd44780_ctx* const ctx);
 
+/**
+ * @brief Wait before next busy flag poll
+ *
+ * @param[in] ctx driver context
+ * @param[in] backoff_us desired wait time [us]
+ *
+ * @return time waited [us], 0 if poll should be repeated immediately
+ */
+static uint32_t s_poll_backoff(const hd44780_ctx* const ctx, uint16_t backoff_us);
+
+/**
+ * @brief Wait for busy flag clear interrupt
+ *
+ * @param[in] ctx driver context
+ *
+ * @return status
+ * @retval HD44780_OK        Success
+ * @retval HD44780_TIMEOUT   Timeout
+ */
+static hd44780_ret_e s_wait_busy_irq(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Wait for busy flag clear using callback or default mechanism
+ *
+ * @param[in] ctx driver context
+ *
+ * @return status
+ * @retval HD44780_OK        Success
+ * @retval HD44780_TIMEOUT   Timeout
+ */
+static hd44780_ret_e s_wait_till_busy(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Delay with best resolution available
+ *
+ * @param[in] ctx driver context
+ * @param[in] time_us time [us]
+ */
+static void s_delay_us(const hd44780_ctx* const ctx, uint32_t time_us);
+
+/**
+ * @brief Execution time scaled for slow controller clones
+ *
+ * @param[in] ctx driver context
+ * @param[in] time_us datasheet execution time [us]
+ *
+ * @return scaled execution time [us]
+ */
+static uint32_t s_exec_time_us(const hd44780_ctx* const ctx, uint32_t time_us);
+
+/**
+ * @brief Start execution time countdown after write in write only mode, or note
+ *        expected execution time for busy flag poll with microseconds delay
+ *
+ * @param[in] ctx driver context
+ * @param[in] time_us datasheet execution time [us]
+ */
+static void s_start_exec_time(const hd44780_ctx* const ctx, uint32_t time_us);
+
+/**
+ * @brief Wait until execution time of last write elapses in write only mode
+ *
+ * @param[in] ctx driver context
+ */
+static void s_wait_exec_time(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Get remaining execution time of last write in write only mode
+ *
+ * @param[in] ctx driver context
+ *
+ * @return time [us]
+ */
+static uint32_t s_exec_time_remaining(const hd44780_ctx* const ctx);
+
 /**
  * @brief Perform read operation on bus
  *
@@ -102,6 +290,25 @@ static void s_write_operation(const hd44780_ctx* const ctx, uint8_t data);
  */
 static void s_write_byte(const hd44780_ctx* const ctx, uint8_t data);
 
+/**
+ * @brief Write byte to instruction or data register, using write cycle callback if available
+ *
+ * @param[in] ctx driver context
+ * @param[in] rs register select pin state
+ * @param[in] data data to be send
+ */
+static void s_write_register(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data);
+
+/**
+ * @brief Read byte from instruction or data register, using read cycle callback if available
+ *
+ * @param[in] ctx driver context
+ * @param[in] rs register select pin state
+ *
+ * @return byte read
+ */
+static uint8_t s_read_register(const hd44780_ctx* const ctx, hd44780_pin_state rs);
+
 /**
  * @brief Writes instruction to lcd
  *
@@ -127,311 +334,2823 @@ static hd44780_ret_e s_write_instruction(const hd44780_ctx* const ctx, uint8_t i
 static hd44780_ret_e s_write_data(const hd44780_ctx* const ctx, uint8_t data);
 
 /**
- * @brief Upload custom characters to CGRAM memory
- * 
+ * @brief Send instruction to lcd, display is expected to be ready
+ *
  * @param[in] ctx driver context
- * @return status
- * @retval HD44780_OK                 Success
- * @retval HD44780_TIMEOUT            Timeout
- * @retval HD44780_CUSTOM_CHARS_INV   Invalid custom characters array
+ * @param[in] instruction instruction
  */
-static hd44780_ret_e s_upload_custom_chars(const hd44780_ctx* const ctx);
-
-/* Static functions implementation */
-
-static void s_config_bus_as_input(const hd44780_ctx* const ctx) {
-  ctx->cb_set_bus_direction(GPIO_DIR_IN);
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_RW, PIN_SET);
-}
+static void s_send_instruction(const hd44780_ctx* const ctx, uint8_t instruction);
 
-static void s_config_bus_as_output(const hd44780_ctx* const ctx) {
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_RW, PIN_RESET);
-  ctx->cb_set_bus_direction(GPIO_DIR_OUT);
-}
+/**
+ * @brief Send data to lcd, display is expected to be ready
+ *
+ * @param[in] ctx driver context
+ * @param[in] data data
+ */
+static void s_send_data(const hd44780_ctx* const ctx, uint8_t data);
 
-static hd44780_ret_e s_wait_till_busy(const hd44780_ctx* const ctx) {
-  hd44780_ret_e ret = HD44780_TIMEOUT;
-  int timeout_ms = HD44780_TIMEOUT_MS;
-  while ((0 <= timeout_ms)) {
-    if (!(hd44780_is_busy(ctx))) {
-      ret = HD44780_OK;
-      break;
-    }
-    ctx->cb_delay_ms(HD44780_TIMEOUT_TICK_MS);
-    timeout_ms -= HD44780_TIMEOUT_TICK_MS;
-  };
-  return ret;
-}
+/**
+ * @brief Send single 8-bit bus cycle instruction used in initialisation sequence
+ *
+ * @param[in] ctx driver context
+ * @param[in] instruction instruction, in case of 4-bit bus only high nibble is sent
+ */
+static void s_send_init_instruction(const hd44780_ctx* const ctx, uint8_t instruction);
 
-static uint8_t s_read_operation(const hd44780_ctx* const ctx) {
-  uint8_t data = 0UL;
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_SET);
-  data = ctx->cb_read_bus();
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_RESET);
-  return data;
-}
+/**
+ * @brief Put operation into asynchronous queue
+ *
+ * @param[in] ctx driver context
+ * @param[in] kind operation kind
+ * @param[in] data instruction, data or tag
+ * @param[in] time_us delay time [us]
+ *
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_QUEUE_FULL Queue is full
+ */
+static hd44780_ret_e s_enqueue(const hd44780_ctx* const ctx, uint8_t kind, uint8_t data, uint16_t time_us);
 
-static uint8_t s_read_byte(const hd44780_ctx* const ctx) {
-  s_config_bus_as_input(ctx);
-  uint8_t data = s_read_operation(ctx);
-  if (ctx->interface == INTERFACE_4BIT) {
-    uint8_t const lower_nibble = s_read_operation(ctx);
-    data |= ((uint8_t)(lower_nibble >> 4U));
-  }
-  return data;
-}
+/**
+ * @brief Write initialisation sequence instruction, blocking or queued
+ *
+ * @param[in] ctx driver context
+ * @param[in] instruction instruction
+ *
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_QUEUE_FULL Queue is full
+ */
+static hd44780_ret_e s_write_init_instruction(const hd44780_ctx* const ctx, uint8_t instruction);
 
-static uint8_t s_read_address(const hd44780_ctx* const ctx) {
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, PIN_RESET);
-  return s_read_byte(ctx);
-}
+/**
+ * @brief Initialisation sequence delay, blocking or queued
+ *
+ * @param[in] ctx driver context
+ * @param[in] time_us time [us]
+ *
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_QUEUE_FULL Queue is full
+ */
+static hd44780_ret_e s_init_delay_us(const hd44780_ctx* const ctx, uint32_t time_us);
 
-static uint8_t s_read_data(const hd44780_ctx* const ctx) {
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, PIN_SET);
-  return s_read_byte(ctx);
-}
+/**
+ * @brief Reset sequence - initialisation by instruction, ends with bus width selected
+ *
+ * @details Three 8 bit function sets bring controller into 8 bit mode from any
+ *          state, including 4 bit mode with lost nibble phase
+ *
+ * @param[in] ctx driver context
+ * @param[in] long_us delay after first function set [us]
+ * @param[in] short_us delay after following function sets [us]
+ *
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_QUEUE_FULL Queue is full
+ */
+static hd44780_ret_e s_reset_sequence(const hd44780_ctx* const ctx, uint32_t long_us, uint32_t short_us);
 
-static void s_write_operation(const hd44780_ctx* const ctx, uint8_t data) {
-  s_config_bus_as_output(ctx);
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_SET);
-  ctx->cb_write_bus(data);
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_RESET);
-}
+/**
+ * @brief Check whether controller is already set up for configured bus width
+ *
+ * @details Probe is always synchronous, set DDRAM address is written and read back.
+ *          Misinterpreted probe of controller in other mode is harmless, since
+ *          reset sequence follows then
+ *
+ * @param[in] ctx driver context
+ *
+ * @return true if reset sequence can be skipped
+ */
+static bool s_controller_set_up(const hd44780_ctx* const ctx);
 
-static void s_write_byte(const hd44780_ctx* const ctx, uint8_t data) {
-  if (ctx->interface == INTERFACE_8BIT) {
-    s_write_operation(ctx, data);
-  } else {
-    s_write_operation(ctx, data);
-    s_write_operation(ctx, (uint8_t)(data << 4));
-  }
-}
+/**
+ * @brief Update runtime state after instruction write
+ *
+ * @param[in] ctx driver context
+ * @param[in] instruction instruction written
+ */
+static void s_track_instruction(const hd44780_ctx* const ctx, uint8_t instruction);
 
-static hd44780_ret_e s_write_instruction(const hd44780_ctx* const ctx, uint8_t instruction) {
-  const hd44780_ret_e ret = ctx->cb_wait_for_busy_flag_clear(ctx);
-  if (HD44780_OK == ret) {
-    ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, PIN_RESET);
-    s_write_byte(ctx, instruction);
-  }
-  return ret;
-}
+/**
+ * @brief Update runtime state after data write
+ *
+ * @param[in] ctx driver context
+ * @param[in] data data written
+ */
+static void s_track_data(const hd44780_ctx* const ctx, uint8_t data);
 
-static hd44780_ret_e s_write_data(const hd44780_ctx* const ctx, uint8_t data) {
-  const hd44780_ret_e ret = ctx->cb_wait_for_busy_flag_clear(ctx);
-  if (HD44780_OK == ret) {
-    ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, PIN_SET);
-    s_write_byte(ctx, data);
-  }
-  return ret;
-}
+/**
+ * @brief Move tracked address counter as display does after data write or read
+ *
+ * @param[in] ctx driver context
+ */
+static void s_track_address_step(const hd44780_ctx* const ctx);
 
-static hd44780_ret_e s_set_ddram_addr(const hd44780_ctx* const ctx, uint8_t address) {
-  return s_write_instruction(ctx, REG_DDRAM_ADDR_SET | address);
-}
+/**
+ * @brief Set address and read run of bytes with address auto increment
+ *
+ * @param[in] ctx driver context, not write only and not asynchronous
+ * @param[in] instruction DDRAM or CGRAM address set instruction
+ * @param[out] buf bytes read
+ * @param[in] len number of bytes
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+static hd44780_ret_e s_read_run(const hd44780_ctx* const ctx, uint8_t instruction, uint8_t* const buf, size_t len);
 
-static hd44780_ret_e s_set_cgram_addr(const hd44780_ctx* const ctx, uint8_t address) {
-  return s_write_instruction(ctx, REG_CGRAM_ADDR_SET | address);
-}
+/**
+ * @brief Get DDRAM address from runtime state
+ *
+ * @param[in] ctx driver context
+ *
+ * @return DDRAM address, ADDR_UNKNOWN if unknown or CGRAM is selected
+ */
+static uint8_t s_ddram_address(const hd44780_ctx* const ctx);
 
-static hd44780_ret_e s_set_char_addr(const hd44780_ctx* const ctx, uint8_t index) {
-  return s_set_cgram_addr(ctx, (index * 8));
-}
+/**
+ * @brief Write custom character pattern into CGRAM
+ *
+ * @param[in] ctx driver context
+ * @param[in] index index of character in memory (starts with 0)
+ * @param[in] pattern pointer to 8 byte character patern array
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+static hd44780_ret_e s_def_char(const hd44780_ctx* const ctx, uint8_t index, const uint8_t* const pattern);
 
-static hd44780_ret_e s_upload_custom_chars(const hd44780_ctx* const ctx)
-{
-  hd44780_ret_e ret = HD44780_OK;
-  if(ctx->custom_chars_map_len > 8) {
-    ret = HD44780_CUSTOM_CHARS_INV;
-    goto exit;
-  }
+/**
+ * @brief Upload custom characters to CGRAM memory
+ * 
+ * @details Maps longer than 8 characters fill glyph cache with first 8 of them
+ * 
+ * @param[in] ctx driver context
+ * @return status
+ * @retval HD44780_OK                 Success
+ * @retval HD44780_TIMEOUT            Timeout
+ * @retval HD44780_CUSTOM_CHARS_INV   Invalid custom characters array
+ */
+static hd44780_ret_e s_upload_custom_chars(const hd44780_ctx* const ctx);
 
-  for(uint8_t i = 0; (i < ctx->custom_chars_map_len) && (ret == HD44780_OK); i++) {
-    ret = hd44780_def_char(ctx, i, ctx->custom_chars_map[i].character_bitmap);
-  }
+/**
+ * @brief Get bit mask of CGRAM characters currently on screen
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return bit mask of CGRAM characters
+ */
+static uint8_t s_cgram_visible(const hd44780_ctx* const ctx);
 
-exit:
-  return ret;
-}
+/**
+ * @brief Find glyph in CGRAM, load it in place of least recently used one if missing
+ * 
+ * @param[in] ctx driver context
+ * @param[in] glyph custom_chars_map index
+ * @param[out] code display character code
+ * 
+ * @return status
+ * @retval HD44780_OK           Success
+ * @retval HD44780_TIMEOUT      Timeout
+ * @retval HD44780_CGRAM_FULL   All CGRAM characters are on screen
+ */
+static hd44780_ret_e s_cache_glyph(const hd44780_ctx* const ctx, uint16_t glyph, uint8_t* const code);
 
-static hd44780_ret_e s_find_character_by_code(const hd44780_ctx* const ctx, const uint32_t utf_8_code, uint8_t* const index) {
-  hd44780_ret_e ret = HD44780_CHAR_NOT_FOUND;
+/**
+ * @brief Decode one UTF-8 character
+ * 
+ * @details Lead byte selects sequence length from table, continuation bytes
+ *          are checked and never read past end of string or terminator.
+ *          Overlong forms, surrogates and codepoints over U+10FFFF are invalid.
+ *          Invalid sequence is consumed up to first unexpected byte.
+ * 
+ * @param[in,out] text string pointer, moved past decoded character
+ * @param[in] end end of string
+ * 
+ * @return unicode codepoint, UTF8_INVALID for invalid sequence
+ */
+static uint32_t s_decode_utf8(const char** text, const char* const end);
 
-  for (uint8_t i = 0; i < ctx->custom_chars_map_len; i++) {
-    if (utf_8_code == ctx->custom_chars_map[i].utf_8_code) {
+/**
+ * @brief Write run of display character codes
+ * 
+ * @details Whole run is passed to cb_write_data_run if provided
+ * 
+ * @param[in] ctx driver context
+ * @param[in] data character codes
+ * @param[in] len number of characters
+ * 
+ * @return status
+ */
+static hd44780_ret_e s_write_run(const hd44780_ctx* const ctx, const uint8_t* data, size_t len);
+
+/**
+ * @brief Translate unicode codepoint into display character code
+ * 
+ * @param[in] ctx driver context
+ * @param[in] codepoint unicode codepoint
+ * @param[out] code display character code
+ * 
+ * @return status
+ * @retval HD44780_OK                Success
+ * @retval HD44780_TIMEOUT           Timeout
+ * @retval HD44780_CHAR_NOT_FOUND    Character not found in ROM and custom chars arrays
+ * @retval HD44780_CGRAM_FULL        No CGRAM character can be evicted for glyph
+ */
+static hd44780_ret_e s_map_codepoint(const hd44780_ctx* const ctx, uint32_t codepoint, uint8_t* const code);
+
+/**
+ * @brief Binary search of codepoint in map sorted by ascending codepoint
+ * 
+ * @details Map elements start with uint32_t codepoint member
+ * 
+ * @param[in] map map pointer
+ * @param[in] element_size size of map element
+ * @param[in] len map length
+ * @param[in] codepoint unicode codepoint
+ * @param[out] index index of found element
+ * 
+ * @return status
+ * @retval HD44780_OK                Success
+ * @retval HD44780_CHAR_NOT_FOUND    Codepoint not found in map
+ */
+static hd44780_ret_e s_search_sorted_map(const void* const map, size_t element_size, uint16_t len,
+                                         uint32_t codepoint, uint16_t* const index);
+
+/**
+ * @brief Search custom characters map for codepoint
+ * 
+ * @param[in] ctx driver context
+ * @param[in] utf_8_code unicode codepoint
+ * @param[out] index index of found character
+ * 
+ * @return status
+ * @retval HD44780_OK                Success
+ * @retval HD44780_CHAR_NOT_FOUND    Character not found in custom chars array
+ */
+static hd44780_ret_e s_find_character_by_code(const hd44780_ctx* const ctx, const uint32_t utf_8_code, uint16_t* const index);
+
+/**
+ * @brief Calculate DDRAM address of display cell
+ * 
+ * @param[in] ctx driver context
+ * @param[in] row row number (0 is at the top)
+ * @param[in] column column number (0 is the leftmost)
+ * 
+ * @return DDRAM address
+ */
+static uint8_t s_cell_address(const hd44780_ctx* const ctx, uint8_t row, uint8_t column);
+
+/**
+ * @brief Calculate framebuffer row index that is n-th in DDRAM address order
+ * 
+ * @details In case of 4 line displays row 2 continues row 0 and row 3 continues
+ *          row 1 in DDRAM, so flushing rows 0, 2, 1, 3 saves address jumps
+ * 
+ * @param[in] ctx driver context
+ * @param[in] n row order number
+ * 
+ * @return row number
+ */
+static uint8_t s_row_in_address_order(const hd44780_ctx* const ctx, uint8_t n);
+
+/**
+ * @brief Check whether overwriting non blank cells is cheaper than Clear Display
+ * 
+ * @details Every non blank cell costs one data write, every run of them
+ *          one address set, plus final address set to mimic Clear Display
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return true if smart clear should be used
+ */
+static bool s_smart_clear_pays_off(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Overwrite non blank cells of shadow buffer with spaces, then set address 0
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ */
+static hd44780_ret_e s_smart_clear(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Reserve command ring slot
+ *
+ * @param[in] ring command ring
+ *
+ * @return reserved slot, NULL if ring is full
+ */
+static hd44780_cmd* s_ring_reserve(hd44780_cmd_ring* const ring);
+
+/**
+ * @brief Hand reserved command ring slot over to consumer
+ *
+ * @param[in] slot reserved slot
+ */
+static void s_ring_commit(hd44780_cmd* const slot);
+
+/**
+ * @brief Execute single ring command
+ *
+ * @param[in] ctx driver context
+ * @param[in] cmd command
+ *
+ * @return status
+ */
+static hd44780_ret_e s_cmd_execute(const hd44780_ctx* const ctx, const hd44780_cmd* const cmd);
+
+/**
+ * @brief Stream marquee characters into DDRAM columns
+ *
+ * @param[in] ctx driver context
+ * @param[in] marquee marquee
+ * @param[in] column first DDRAM column
+ * @param[in] count number of columns, wraps around DDRAM line
+ *
+ * @return status
+ */
+static hd44780_ret_e s_marquee_fill(const hd44780_ctx* const ctx, hd44780_marquee* const marquee, uint8_t column, uint8_t count);
+
+/**
+ * @brief Check bus group, members need framebuffers of the same geometry and no queue
+ *
+ * @param[in] group bus group
+ *
+ * @return true if group can be flushed
+ */
+static bool s_group_valid(const hd44780_group* const group);
+
+/**
+ * @brief Write cells equal on every member of bus group with broadcast context
+ *
+ * @param[in] group bus group
+ *
+ * @return status
+ */
+static hd44780_ret_e s_group_broadcast_cells(const hd44780_group* const group);
+
+/**
+ * @brief Resumable framebuffer flush, writes at most one byte
+ *
+ * @param[in] ctx driver context
+ * @param[in,out] pos next cell, counted in address order
+ * @param[out] done set when there is nothing left to be written
+ *
+ * @return status
+ */
+static hd44780_ret_e s_flush_step(const hd44780_ctx* const ctx, uint16_t* const pos, bool* const done);
+
+/**
+ * @brief Fill framebuffer frames with spaces and assign their roles
+ *
+ * @param[in] ctx driver context with framebuffer
+ */
+static void s_fb_frames_init(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Get framebuffer render target, back frame when frames are given
+ *
+ * @param[in] fb framebuffer
+ *
+ * @return render target
+ */
+static uint8_t* s_fb_target(const hd44780_fb* const fb);
+
+/**
+ * @brief Take the newest published frame for flush, if there is one
+ *
+ * @param[in] fb framebuffer
+ */
+static void s_fb_acquire(hd44780_fb* const fb);
+
+/**
+ * @brief Check whether frames are given together with glyph cache
+ *
+ * @details Glyph cache loads CGRAM while text is rendered, with frames rendering
+ *          runs on other task than flush and must not touch bus nor state
+ *
+ * @param[in] ctx driver context
+ *
+ * @return true if context is invalid
+ */
+static bool s_fb_frames_conflict(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Find animation with pattern row to be written, moves due animations to next frame
+ *
+ * @param[in] ctx driver context
+ *
+ * @return animation, NULL if there is nothing to be written
+ */
+static hd44780_anim* s_anim_pending(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Choose next animation bus operation
+ *
+ * @param[in] ctx driver context
+ * @param[in] idle queue is empty
+ * @param[out] op operation to be executed
+ *
+ * @return animation step (ANIM_STEP_*), ANIM_STEP_NONE if there is nothing to be done
+ */
+static uint8_t s_anim_next(const hd44780_ctx* const ctx, bool idle, hd44780_op* const op);
+
+/**
+ * @brief Update animation state after operation has been executed
+ *
+ * @param[in] ctx driver context
+ * @param[in] step animation step returned by s_anim_next()
+ * @param[in] op executed operation
+ */
+static void s_anim_commit(const hd44780_ctx* const ctx, uint8_t step, const hd44780_op* const op);
+
+/**
+ * @brief Map codepoint and put it at framebuffer render position, dropped past end of row
+ *
+ * @param[in] ctx driver context with framebuffer
+ * @param[in] codepoint unicode codepoint
+ *
+ * @return status of s_map_codepoint()
+ */
+static hd44780_ret_e s_fb_put(const hd44780_ctx* const ctx, uint32_t codepoint);
+
+/**
+ * @brief Put character into framebuffer number of times
+ *
+ * @param[in] ctx driver context with framebuffer
+ * @param[in] ch ASCII character
+ * @param[in] count number of characters
+ *
+ * @return status of s_fb_put()
+ */
+static hd44780_ret_e s_fb_pad(const hd44780_ctx* const ctx, char ch, uint8_t count);
+
+/**
+ * @brief Parse width or precision digits of conversion
+ *
+ * @param[in,out] fmt format string, moved past digits
+ * @param[in] limit value saturation, row width
+ * @param[out] value parsed value, saturated at limit
+ *
+ * @return false if number does not fit in uint8_t
+ */
+static bool s_fmt_field(const char** fmt, uint8_t limit, uint8_t* value);
+
+/**
+ * @brief Put string conversion into framebuffer
+ *
+ * @param[in] ctx driver context with framebuffer
+ * @param[in] text null terminated UTF-8 string
+ * @param[in] width minimum number of characters
+ * @param[in] precision maximum number of characters, FMT_NO_PRECISION for whole string
+ * @param[in] flags FMT_LEFT
+ *
+ * @return status of s_fb_put()
+ */
+static hd44780_ret_e s_fb_put_text(const hd44780_ctx* const ctx, const char* text, uint8_t width, uint8_t precision,
+                                   uint8_t flags);
+
+/**
+ * @brief Put integer conversion into framebuffer
+ *
+ * @param[in] ctx driver context with framebuffer
+ * @param[in] magnitude absolute value
+ * @param[in] negative value is negative
+ * @param[in] base 10 or 16
+ * @param[in] width minimum number of characters
+ * @param[in] decimals fixed-point fraction digits, 0 for integer
+ * @param[in] flags FMT_LEFT, FMT_ZERO, FMT_UPPER
+ *
+ * @return status of s_fb_put()
+ */
+static hd44780_ret_e s_fb_put_number(const hd44780_ctx* const ctx, unsigned long magnitude, bool negative,
+                                     uint8_t base, uint8_t width, uint8_t decimals, uint8_t flags);
+
+#if HD44780_STATS
+/**
+ * @brief Count bus transaction and pass it to cb_trace
+ *
+ * @param[in] ctx driver context
+ * @param[in] kind transaction kind
+ * @param[in] data byte written or read
+ * @param[in] len number of bytes
+ */
+static void s_trace(const hd44780_ctx* const ctx, hd44780_trace_kind kind, uint8_t data, uint16_t len);
+#endif
+
+/* Static functions implementation */
+
+static void s_config_bus_as_input(const hd44780_ctx* const ctx) {
+  if (GPIO_DIR_IN != ctx->state->bus_direction) {
+    ctx->cb_set_bus_direction(GPIO_DIR_IN);
+    if (NULL != ctx->cb_set_ctrl_pin_state) {
+      ctx->cb_set_ctrl_pin_state(HD44780_PIN_RW, PIN_SET);
+    }
+    ctx->state->bus_direction = GPIO_DIR_IN;
+    TRACE(ctx, HD44780_TRACE_BUS_DIRECTION, GPIO_DIR_IN, 1U);
+  }
+}
+
+static void s_config_bus_as_output(const hd44780_ctx* const ctx) {
+  if (GPIO_DIR_OUT != ctx->state->bus_direction) {
+    if ((!IS_WRITE_ONLY(ctx)) && (NULL != ctx->cb_set_ctrl_pin_state)) {
+      ctx->cb_set_ctrl_pin_state(HD44780_PIN_RW, PIN_RESET);
+    }
+    if (NULL != ctx->cb_set_bus_direction) {
+      ctx->cb_set_bus_direction(GPIO_DIR_OUT);
+    }
+    ctx->state->bus_direction = GPIO_DIR_OUT;
+    TRACE(ctx, HD44780_TRACE_BUS_DIRECTION, GPIO_DIR_OUT, 1U);
+  }
+}
+
+static void s_delay_us(const hd44780_ctx* const ctx, uint32_t time_us) {
+  if (NULL != ctx->cb_delay_us) {
+    while (time_us > UINT16_MAX) {
+      ctx->cb_delay_us(UINT16_MAX);
+      time_us -= UINT16_MAX;
+    }
+    ctx->cb_delay_us((uint16_t)time_us);
+  } else if (NULL != ctx->cb_get_time_us) {
+    const uint32_t start_us = ctx->cb_get_time_us();
+    while ((ctx->cb_get_time_us() - start_us) < time_us) {
+      /* intentionally do nothing */
+    }
+  } else {
+    uint32_t time_ms = (time_us + 999U) / 1000U;
+    while (time_ms > UINT8_MAX) {
+      ctx->cb_delay_ms(UINT8_MAX);
+      time_ms -= UINT8_MAX;
+    }
+    ctx->cb_delay_ms((uint8_t)time_ms);
+  }
+}
+
+static uint32_t s_exec_time_us(const hd44780_ctx* const ctx, uint32_t time_us) {
+  const uint32_t scale_pct = (0U != ctx->exec_time_scale_pct) ? ctx->exec_time_scale_pct : HD44780_EXEC_TIME_SCALE_PCT;
+  return ((time_us * scale_pct) + 99U) / 100U;
+}
+
+static void s_start_exec_time(const hd44780_ctx* const ctx, uint32_t time_us) {
+  hd44780_state* const state = ctx->state;
+  bool timed = true;
+
+  if (IS_WRITE_ONLY(ctx)) {
+    state->exec_time_us = (uint16_t)s_exec_time_us(ctx, time_us);
+  } else if (NULL != ctx->cb_delay_us) {
+    /* Busy flag tells the end, datasheet time is expected unless scale is configured */
+    state->poll_expect_us = (uint16_t)((0U != ctx->exec_time_scale_pct) ? s_exec_time_us(ctx, time_us) : time_us);
+  } else {
+    timed = false;
+  }
+  if (timed && (NULL != ctx->cb_get_time_us)) {
+    state->exec_start_us = ctx->cb_get_time_us();
+  }
+}
+
+static void s_send_instruction(const hd44780_ctx* const ctx, uint8_t instruction) {
+  s_write_register(ctx, PIN_RESET, instruction);
+  s_start_exec_time(ctx, (instruction <= (REG_HOME | REG_CLEAR)) ? EXEC_TIME_LONG_US : EXEC_TIME_US);
+}
+
+static void s_send_data(const hd44780_ctx* const ctx, uint8_t data) {
+  s_write_register(ctx, PIN_SET, data);
+  s_start_exec_time(ctx, EXEC_TIME_US);
+}
+
+static void s_send_init_instruction(const hd44780_ctx* const ctx, uint8_t instruction) {
+  if (HAS_WRITE_CYCLE(ctx)) {
+    s_config_bus_as_output(ctx);
+    WRITE_CYCLE(ctx, PIN_RESET, instruction, false);
+  } else {
+    ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, PIN_RESET);
+    s_write_operation(ctx, instruction);
+  }
+  TRACE(ctx, HD44780_TRACE_INSTRUCTION, instruction, 1U);
+  if (IS_WRITE_ONLY(ctx)) {
+    s_start_exec_time(ctx, EXEC_TIME_US);
+  }
+}
+
+static hd44780_ret_e s_enqueue(const hd44780_ctx* const ctx, uint8_t kind, uint8_t data, uint16_t time_us) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_state* const state = ctx->state;
+  const uint16_t head = state->queue_head;
+  const uint16_t next = ((head + 1U) < ctx->queue_len) ? (head + 1U) : 0U;
+
+  if (next == state->queue_tail) {
+    ret = HD44780_QUEUE_FULL;
+  } else {
+    /* Element has to be complete before head moves, consumer might be an interrupt */
+    volatile hd44780_op* const op = &ctx->queue[head];
+    op->kind = kind;
+    op->data = data;
+    op->time_us = time_us;
+    state->queue_head = next;
+  }
+
+  return ret;
+}
+
+static hd44780_ret_e s_write_init_instruction(const hd44780_ctx* const ctx, uint8_t instruction) {
+  hd44780_ret_e ret = HD44780_OK;
+  if (HAS_QUEUE(ctx)) {
+    ret = s_enqueue(ctx, OP_NIBBLE, instruction, 0U);
+  } else {
+    s_send_init_instruction(ctx, instruction);
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_init_delay_us(const hd44780_ctx* const ctx, uint32_t time_us) {
+  hd44780_ret_e ret = HD44780_OK;
+  if (HAS_QUEUE(ctx)) {
+    while ((HD44780_OK == ret) && (0U < time_us)) {
+      const uint16_t chunk_us = (time_us > UINT16_MAX) ? UINT16_MAX : (uint16_t)time_us;
+      ret = s_enqueue(ctx, OP_DELAY, 0U, chunk_us);
+      time_us -= chunk_us;
+    }
+  } else {
+    s_delay_us(ctx, time_us);
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_reset_sequence(const hd44780_ctx* const ctx, uint32_t long_us, uint32_t short_us) {
+  hd44780_ret_e ret = s_write_init_instruction(ctx, REG_INTERFACE | REG_8_BIT_BUS);
+  if (HD44780_OK == ret) {
+    ret = s_init_delay_us(ctx, long_us);
+  }
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < 2U); i++) {
+    ret = s_write_init_instruction(ctx, REG_INTERFACE | REG_8_BIT_BUS);
+    if (HD44780_OK == ret) {
+      ret = s_init_delay_us(ctx, short_us);
+    }
+  }
+  if ((HD44780_OK == ret) && IS_4BIT(ctx)) {
+    ret = s_write_init_instruction(ctx, REG_INTERFACE | REG_4_BIT_BUS);
+    if (HD44780_OK == ret) {
+      ret = s_init_delay_us(ctx, short_us);
+    }
+  }
+  return ret;
+}
+
+static bool s_controller_set_up(const hd44780_ctx* const ctx) {
+  bool set_up = false;
+
+  if ((!ctx->warm_init) || IS_WRITE_ONLY(ctx)) {
+    goto exit;
+  }
+  /* Controller which is set up finishes even the longest instruction meanwhile */
+  if (hd44780_is_busy(ctx)) {
+    s_delay_us(ctx, EXEC_TIME_LONG_US);
+    if (hd44780_is_busy(ctx)) {
+      goto exit;
+    }
+  }
+  s_send_instruction(ctx, REG_DDRAM_ADDR_SET | WARM_PROBE_ADDR);
+  s_delay_us(ctx, EXEC_TIME_US * 2U);
+  set_up = (WARM_PROBE_ADDR == s_read_address(ctx));
+
+exit:
+  return set_up;
+}
+
+static uint32_t s_exec_time_remaining(const hd44780_ctx* const ctx) {
+  uint32_t remaining_us = ctx->state->exec_time_us;
+  if ((0U != remaining_us) && (NULL != ctx->cb_get_time_us)) {
+    const uint32_t elapsed_us = ctx->cb_get_time_us() - ctx->state->exec_start_us;
+    remaining_us = (elapsed_us < remaining_us) ? (remaining_us - elapsed_us) : 0U;
+  }
+  return remaining_us;
+}
+
+static void s_wait_exec_time(const hd44780_ctx* const ctx) {
+  const uint32_t remaining_us = s_exec_time_remaining(ctx);
+  if (0U != remaining_us) {
+    s_delay_us(ctx, remaining_us);
+    STATS_ADD(ctx, busy_wait_us, remaining_us);
+  }
+  ctx->state->exec_time_us = 0U;
+}
+
+static uint32_t s_poll_backoff(const hd44780_ctx* const ctx, uint16_t backoff_us) {
+  uint32_t waited_us = 0U;
+  if (NULL != ctx->cb_delay_us) {
+    ctx->cb_delay_us(backoff_us);
+    waited_us = backoff_us;
+  } else if (NULL == ctx->cb_get_time_us) {
+    ctx->cb_delay_ms(HD44780_TIMEOUT_TICK_MS);
+    waited_us = HD44780_TIMEOUT_TICK_MS * 1000UL;
+  }
+  return waited_us;
+}
+
+static hd44780_ret_e s_wait_busy_irq(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  s_config_bus_as_input(ctx);
+  ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, PIN_RESET);
+  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_SET);
+  while (ctx->cb_read_bus() & 0x80) {
+    ctx->cb_busy_wait_begin(ctx);
+    /* Busy flag might be cleared before interrupt got armed */
+    if (!(ctx->cb_read_bus() & 0x80)) {
+      break;
+    }
+    if (!ctx->cb_busy_wait_signalled(ctx, HD44780_TIMEOUT_MS)) {
+      ret = HD44780_TIMEOUT;
+      break;
+    }
+  }
+  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_RESET);
+
+  /* Lower nibble of address has to be clocked out to keep nibble phase */
+  if (IS_4BIT(ctx)) {
+    (void)s_read_operation(ctx);
+  }
+
+  return ret;
+}
+
+static hd44780_ret_e s_wait_till_busy(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  if (IS_WRITE_ONLY(ctx)) {
+    if (!ctx->state->paced) {
+      s_wait_exec_time(ctx);
+    }
+  } else {
+    const uint32_t start_us = STATS_TIME_US(ctx);
+    if (NULL != ctx->cb_wait_for_busy_flag_clear) {
+      ret = ctx->cb_wait_for_busy_flag_clear(ctx);
+    } else {
+      ret = hd44780_wait_while_busy(ctx);
+    }
+    STATS_ADD(ctx, busy_wait_us, STATS_TIME_US(ctx) - start_us);
+  }
+  if (HD44780_TIMEOUT == ret) {
+    STATS_ADD(ctx, timeouts, 1U);
+  }
+  return ret;
+}
+
+static uint8_t s_read_operation(const hd44780_ctx* const ctx) {
+  uint8_t data = 0UL;
+  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_SET);
+  data = ctx->cb_read_bus();
+  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_RESET);
+  return data;
+}
+
+static uint8_t s_read_byte(const hd44780_ctx* const ctx) {
+  s_config_bus_as_input(ctx);
+  uint8_t data = s_read_operation(ctx);
+  if (IS_4BIT(ctx)) {
+    uint8_t const lower_nibble = s_read_operation(ctx);
+    data |= ((uint8_t)(lower_nibble >> 4U));
+  }
+  return data;
+}
+
+static uint8_t s_read_register(const hd44780_ctx* const ctx, hd44780_pin_state rs) {
+  uint8_t data = 0U;
+  if (HAS_READ_CYCLE(ctx)) {
+    s_config_bus_as_input(ctx);
+    data = READ_CYCLE(ctx, rs, IS_4BIT(ctx));
+  } else {
+    ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, rs);
+    data = s_read_byte(ctx);
+  }
+  TRACE(ctx, (PIN_SET == rs) ? HD44780_TRACE_READ_DATA : HD44780_TRACE_READ_ADDRESS, data, 1U);
+  return data;
+}
+
+static uint8_t s_read_address(const hd44780_ctx* const ctx) {
+  return s_read_register(ctx, PIN_RESET);
+}
+
+static uint8_t s_read_data(const hd44780_ctx* const ctx) {
+  return s_read_register(ctx, PIN_SET);
+}
+
+static void s_write_operation(const hd44780_ctx* const ctx, uint8_t data) {
+  s_config_bus_as_output(ctx);
+  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_SET);
+  ctx->cb_write_bus(data);
+  ctx->cb_set_ctrl_pin_state(HD44780_PIN_E, PIN_RESET);
+}
+
+static void s_write_byte(const hd44780_ctx* const ctx, uint8_t data) {
+  if (!IS_4BIT(ctx)) {
+    s_write_operation(ctx, data);
+  } else {
+    s_write_operation(ctx, data);
+    s_write_operation(ctx, (uint8_t)(data << 4));
+  }
+}
+
+static void s_write_register(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data) {
+  if (HAS_WRITE_CYCLE(ctx)) {
+    s_config_bus_as_output(ctx);
+    WRITE_CYCLE(ctx, rs, data, IS_4BIT(ctx));
+  } else {
+    ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, rs);
+    s_write_byte(ctx, data);
+  }
+  TRACE(ctx, (PIN_SET == rs) ? HD44780_TRACE_DATA : HD44780_TRACE_INSTRUCTION, data, 1U);
+}
+
+static void s_track_instruction(const hd44780_ctx* const ctx, uint8_t instruction) {
+  hd44780_state* const state = ctx->state;
+  if (instruction & REG_DDRAM_ADDR_SET) {
+    state->address = instruction & (uint8_t)(~REG_DDRAM_ADDR_SET);
+    state->cgram_selected = false;
+  } else if (instruction & REG_CGRAM_ADDR_SET) {
+    state->address = instruction & CGRAM_ADDR_MASK;
+    state->cgram_selected = true;
+  } else if (instruction & REG_INTERFACE) {
+    /* Function set does not affect tracked state */
+  } else if (instruction & REG_DISPLAY_SHIFT) {
+    if (instruction & REG_SHIFT_DISPLAY) {
+      state->display_shift = (instruction & REG_SHIFT_RIGHT) ?
+                             (uint8_t)((state->display_shift + DDRAM_LINE_LEN - 1U) % DDRAM_LINE_LEN) :
+                             (uint8_t)((state->display_shift + 1U) % DDRAM_LINE_LEN);
+    } else {
+      /* Cursor shift moves address counter */
+      state->address = ADDR_UNKNOWN;
+    }
+  } else if (instruction & REG_PWR_AND_CURSOR) {
+    state->display_ctrl = instruction;
+  } else if (instruction & REG_EM) {
+    state->entry_mode = instruction;
+  } else if (instruction & REG_HOME) {
+    state->address = 0U;
+    state->cgram_selected = false;
+    state->display_shift = 0U;
+  } else if (instruction & REG_CLEAR) {
+    state->address = 0U;
+    state->cgram_selected = false;
+    state->display_shift = 0U;
+    state->cgram_visible = 0U;
+    state->entry_mode |= REG_EM | REG_EM_INCREMENT;
+  }
+}
+
+static void s_track_data(const hd44780_ctx* const ctx, uint8_t data) {
+  hd44780_state* const state = ctx->state;
+  if ((!state->cgram_selected) && (data < (2U * CGRAM_CHARS))) {
+    /* Codes 8 ... 15 mirror CGRAM characters 0 ... 7 */
+    state->cgram_visible |= (uint8_t)(1U << (data % CGRAM_CHARS));
+  }
+  if ((ADDR_UNKNOWN != state->address) && (state->cgram_selected)) {
+    state->cgram[state->address] = data;
+  }
+  s_track_address_step(ctx);
+}
+
+static void s_track_address_step(const hd44780_ctx* const ctx) {
+  hd44780_state* const state = ctx->state;
+  const bool increment = (0U != (state->entry_mode & REG_EM_INCREMENT));
+  if (ADDR_UNKNOWN == state->address) {
+    return;
+  }
+
+  if (state->cgram_selected) {
+    state->address = (uint8_t)(increment ? (state->address + 1U) : (state->address - 1U)) & CGRAM_ADDR_MASK;
+  } else if (increment) {
+    /* Two line mode, DDRAM lines are 0x00 ... 0x27 and 0x40 ... 0x67 */
+    state->address++;
+    if (state->address == DDRAM_LINE_LEN) {
+      state->address = DDRAM_LINE_2_START;
+    } else if (state->address == (DDRAM_LINE_2_START + DDRAM_LINE_LEN)) {
+      state->address = 0U;
+    }
+  } else {
+    if (state->address == 0U) {
+      state->address = DDRAM_LINE_2_START + DDRAM_LINE_LEN;
+    } else if (state->address == DDRAM_LINE_2_START) {
+      state->address = DDRAM_LINE_LEN;
+    }
+    state->address--;
+  }
+}
+
+static hd44780_ret_e s_read_run(const hd44780_ctx* const ctx, uint8_t instruction, uint8_t* const buf, size_t len) {
+  /* Address set is needed even if counter is there already, read right after write returns wrong data */
+  hd44780_ret_e ret = s_write_instruction(ctx, instruction);
+  for (size_t i = 0U; (HD44780_OK == ret) && (i < len); i++) {
+    ret = s_wait_till_busy(ctx);
+    if (HD44780_OK == ret) {
+      buf[i] = s_read_data(ctx);
+      s_track_address_step(ctx);
+    }
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_write_instruction(const hd44780_ctx* const ctx, uint8_t instruction) {
+  hd44780_ret_e ret = HD44780_OK;
+  if (HAS_QUEUE(ctx)) {
+    /* Tick does not start animation while tracked state lags behind queue */
+    ctx->state->producing = true;
+    ret = s_enqueue(ctx, OP_INSTRUCTION, instruction, 0U);
+  } else {
+    ret = s_wait_till_busy(ctx);
+    if (HD44780_OK == ret) {
+      s_send_instruction(ctx, instruction);
+    }
+  }
+  if (HD44780_OK == ret) {
+    s_track_instruction(ctx, instruction);
+  }
+  ctx->state->producing = false;
+  return ret;
+}
+
+static hd44780_ret_e s_write_data(const hd44780_ctx* const ctx, uint8_t data) {
+  hd44780_ret_e ret = HD44780_OK;
+  if (HAS_QUEUE(ctx)) {
+    ctx->state->producing = true;
+    ret = s_enqueue(ctx, OP_DATA, data, 0U);
+  } else {
+    ret = s_wait_till_busy(ctx);
+    if (HD44780_OK == ret) {
+      s_send_data(ctx, data);
+    }
+  }
+  if (HD44780_OK == ret) {
+    s_track_data(ctx, data);
+  }
+  ctx->state->producing = false;
+  return ret;
+}
+
+static hd44780_ret_e s_set_ddram_addr(const hd44780_ctx* const ctx, uint8_t address) {
+  hd44780_ret_e ret = HD44780_OK;
+  if ((ctx->state->cgram_selected) || (ctx->state->address != address)) {
+    ret = s_write_instruction(ctx, REG_DDRAM_ADDR_SET | address);
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_set_cgram_addr(const hd44780_ctx* const ctx, uint8_t address) {
+  return s_write_instruction(ctx, REG_CGRAM_ADDR_SET | address);
+}
+
+static hd44780_ret_e s_set_char_addr(const hd44780_ctx* const ctx, uint8_t index) {
+  return s_set_cgram_addr(ctx, (index * 8));
+}
+
+static uint8_t s_ddram_address(const hd44780_ctx* const ctx) {
+  return ctx->state->cgram_selected ? ADDR_UNKNOWN : ctx->state->address;
+}
+
+static hd44780_ret_e s_def_char(const hd44780_ctx* const ctx, uint8_t index, const uint8_t* const pattern) {
+  hd44780_ret_e ret = s_set_char_addr(ctx, index);
+  for (uint8_t i = 0; ((HD44780_OK == ret) && (i < 8)); i++) {
+    ret = s_write_data(ctx, pattern[i]);
+  }
+  if (HD44780_OK == ret) {
+    ctx->state->cgram_loaded |= (uint8_t)(1U << index);
+    STATS_ADD(ctx, cgram_uploads, 1U);
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_upload_custom_chars(const hd44780_ctx* const ctx)
+{
+  hd44780_ret_e ret = HD44780_OK;
+  const uint8_t ddram_address = s_ddram_address(ctx);
+  if ((0U < ctx->custom_chars_map_len) && (NULL == ctx->custom_chars_map)) {
+    ret = HD44780_CUSTOM_CHARS_INV;
+    goto exit;
+  }
+
+  for (uint8_t i = 0U; i < CGRAM_CHARS; i++) {
+    ctx->state->cgram_glyph[i] = GLYPH_NONE;
+    ctx->state->cgram_lru[i] = i;
+  }
+  for(uint8_t i = 0; (i < ctx->custom_chars_map_len) && (i < CGRAM_CHARS) && (ret == HD44780_OK); i++) {
+    ret = s_def_char(ctx, i, ctx->custom_chars_map[i].character_bitmap);
+    ctx->state->cgram_glyph[i] = i;
+  }
+  if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+    ret = s_set_ddram_addr(ctx, ddram_address);
+  }
+
+exit:
+  return ret;
+}
+
+static uint8_t s_cgram_visible(const hd44780_ctx* const ctx) {
+  const hd44780_fb* const fb = ctx->framebuffer;
+  uint8_t visible = 0U;
+
+  if ((NULL == fb) || (fb->stale)) {
+    visible = ctx->state->cgram_visible;
+  } else {
+    /* Characters waiting for flush are protected as well as those on display */
+    const uint16_t cells = (uint16_t)ctx->number_of_lines * ctx->column_width;
+    for (uint16_t i = 0U; i < cells; i++) {
+      if (fb->cells[i] < (2U * CGRAM_CHARS)) {
+        visible |= (uint8_t)(1U << (fb->cells[i] % CGRAM_CHARS));
+      }
+      if (fb->shadow[i] < (2U * CGRAM_CHARS)) {
+        visible |= (uint8_t)(1U << (fb->shadow[i] % CGRAM_CHARS));
+      }
+    }
+  }
+
+  return visible;
+}
+
+static hd44780_ret_e s_cache_glyph(const hd44780_ctx* const ctx, uint16_t glyph, uint8_t* const code) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_state* const state = ctx->state;
+  uint8_t pos = 0U;
+
+  while ((pos < CGRAM_CHARS) && (glyph != state->cgram_glyph[state->cgram_lru[pos]])) {
+    pos++;
+  }
+
+  if (CGRAM_CHARS == pos) {
+    const uint8_t visible = s_cgram_visible(ctx);
+    while ((0U < pos) && (visible & (1U << state->cgram_lru[pos - 1U]))) {
+      pos--;
+    }
+    if (0U == pos) {
+      ret = HD44780_CGRAM_FULL;
+      goto exit;
+    }
+    pos--;
+
+    const uint8_t slot = state->cgram_lru[pos];
+    const uint8_t ddram_address = s_ddram_address(ctx);
+    ret = s_def_char(ctx, slot, ctx->custom_chars_map[glyph].character_bitmap);
+    if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+      ret = s_set_ddram_addr(ctx, ddram_address);
+    }
+    if (HD44780_OK != ret) {
+      /* Character might be partially overwritten */
+      state->cgram_glyph[slot] = GLYPH_NONE;
+      goto exit;
+    }
+    state->cgram_glyph[slot] = glyph;
+  }
+
+  /* Move to the front of recently used list */
+  *code = state->cgram_lru[pos];
+  memmove(&state->cgram_lru[1], &state->cgram_lru[0], pos);
+  state->cgram_lru[0] = *code;
+
+exit:
+  return ret;
+}
+
+static hd44780_ret_e s_search_sorted_map(const void* const map, size_t element_size, uint16_t len,
+                                         uint32_t codepoint, uint16_t* const index) {
+  hd44780_ret_e ret = HD44780_CHAR_NOT_FOUND;
+  uint16_t low = 0U;
+  uint16_t high = len;
+
+  while (low < high) {
+    const uint16_t mid = (uint16_t)(low + ((high - low) / 2U));
+    const uint32_t mid_codepoint = *(const uint32_t*)((const uint8_t*)map + (mid * element_size));
+    if (mid_codepoint < codepoint) {
+      low = mid + 1U;
+    } else if (mid_codepoint > codepoint) {
+      high = mid;
+    } else {
+      *index = mid;
+      ret = HD44780_OK;
+      break;
+    }
+  }
+
+  return ret;
+}
+
+static hd44780_ret_e s_find_character_by_code(const hd44780_ctx* const ctx, const uint32_t utf_8_code, uint16_t* const index) {
+  hd44780_ret_e ret = HD44780_CHAR_NOT_FOUND;
+
+  if (ctx->custom_chars_map_sorted) {
+    ret = s_search_sorted_map(ctx->custom_chars_map, sizeof(character_mapping), ctx->custom_chars_map_len,
+                              utf_8_code, index);
+    goto exit;
+  }
+
+  for (uint16_t i = 0; i < ctx->custom_chars_map_len; i++) {
+    if (utf_8_code == ctx->custom_chars_map[i].utf_8_code) {
       *index = i;
       ret = HD44780_OK;
       break;
     }
   }
 
+exit:
+  return ret;
+}
+
+static uint32_t s_decode_utf8(const char** text, const char* const end) {
+  /* Sequence length indexed by 5 most significant bits of lead byte, 0 if invalid */
+  static const uint8_t utf8_len[32] = {
+    1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U,
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 2U, 2U, 2U, 2U, 3U, 3U, 4U, 0U,
+  };
+  static const uint8_t utf8_lead_mask[5] = { 0x00U, 0x7FU, 0x1FU, 0x0FU, 0x07U };
+  static const uint32_t utf8_min[5] = { 0U, 0U, 0x80UL, 0x800UL, 0x10000UL };
+
+  const uint8_t* p = (const uint8_t*)*text;
+  const uint8_t* const p_end = (const uint8_t*)end;
+  const uint8_t len = utf8_len[*p >> 3U];
+  uint32_t codepoint = *p++ & utf8_lead_mask[len];
+  uint8_t i = 1U;
+
+  while ((i < len) && (p < p_end) && (0x80U == (*p & 0xC0U))) {
+    codepoint = (codepoint << 6U) | (*p++ & 0x3FU);
+    i++;
+  }
+
+  if ((0U == len) || (i < len) || (codepoint < utf8_min[len]) || (0x10FFFFUL < codepoint) ||
+      ((0xD800UL <= codepoint) && (codepoint <= 0xDFFFUL))) {
+    codepoint = UTF8_INVALID;
+  }
+
+  *text = (const char*)p;
+  return codepoint;
+}
+
+static hd44780_ret_e s_map_codepoint(const hd44780_ctx* const ctx, uint32_t codepoint, uint8_t* const code) {
+  hd44780_ret_e ret = HD44780_OK;
+  uint16_t index = 0U;
+  if (codepoint <= 0x7f) {
+    *code = (uint8_t)codepoint;
+  } else if (UTF8_INVALID == codepoint) {
+    *code = HD44780_REPLACEMENT_CHAR;
+  } else if ((NULL != ctx->rom_chars_map) &&
+             (HD44780_OK == s_search_sorted_map(ctx->rom_chars_map, sizeof(rom_char_mapping),
+                                                ctx->rom_chars_map_len, codepoint, &index))) {
+    *code = ctx->rom_chars_map[index].rom_code;
+  } else {
+    ret = s_find_character_by_code(ctx, codepoint, &index);
+    if ((HD44780_OK == ret) && (CGRAM_CHARS < ctx->custom_chars_map_len)) {
+      ret = s_cache_glyph(ctx, index, code);
+    } else if (HD44780_OK == ret) {
+      *code = (uint8_t)index;
+    }
+  }
+  return ret;
+}
+
+static uint8_t s_cell_address(const hd44780_ctx* const ctx, uint8_t row, uint8_t column) {
+  uint8_t address = column;
+  switch (row) {
+    case 1:
+      address += 0x40U;
+      break;
+    case 2:
+      address += ctx->column_width;
+      break;
+    case 3:
+      address += 0x40U;
+      address += ctx->column_width;
+      break;
+    case 0: /* intentionally fallthrough */
+    default:
+      break;
+  }
+  return address;
+}
+
+static uint8_t s_row_in_address_order(const hd44780_ctx* const ctx, uint8_t n) {
+  static const uint8_t order[4U] = {0U, 2U, 1U, 3U};
+  return (ctx->number_of_lines == 4U) ? order[n] : n;
+}
+
+/* "Public" functions implementation */
+
+static bool s_smart_clear_pays_off(const hd44780_ctx* const ctx) {
+  const hd44780_fb* const fb = ctx->framebuffer;
+  const uint8_t entry_mode = ctx->state->entry_mode & (REG_EM_INCREMENT | REG_EM_SHIFT_DISPLAY);
+  uint8_t address = ctx->state->cgram_selected ? ADDR_UNKNOWN : ctx->state->address;
+  uint32_t instructions = 0U;
+
+  /* Clear Display also brings shifted display back */
+  if ((!ctx->smart_clear) || (NULL == fb) || (fb->stale) || (REG_EM_INCREMENT != entry_mode) ||
+      (0U != ctx->state->display_shift)) {
+    return false;
+  }
+
+  /* Same traversal as s_smart_clear(), address set is counted where it is sent */
+  for (uint8_t n = 0U; n < ctx->number_of_lines; n++) {
+    const uint8_t row = s_row_in_address_order(ctx, n);
+    for (uint8_t column = 0U; column < ctx->column_width; column++) {
+      const uint16_t i = ((uint16_t)row * ctx->column_width) + column;
+      if (FB_BLANK == fb->shadow[i]) {
+        continue;
+      }
+      const uint8_t cell = s_cell_address(ctx, row, column);
+      instructions += (cell == address) ? 1U : 2U;
+      address = (uint8_t)(cell + 1U);
+      if (DDRAM_LINE_LEN == address) {
+        address = DDRAM_LINE_2_START;
+      } else if ((DDRAM_LINE_2_START + DDRAM_LINE_LEN) == address) {
+        address = 0U;
+      }
+    }
+  }
+  instructions += (0U == address) ? 0U : 1U;
+
+  return ((instructions * EXEC_TIME_US) < EXEC_TIME_LONG_US);
+}
+
+static hd44780_ret_e s_smart_clear(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_fb* const fb = ctx->framebuffer;
+
+  for (uint8_t n = 0U; n < ctx->number_of_lines; n++) {
+    const uint8_t row = s_row_in_address_order(ctx, n);
+    for (uint8_t column = 0U; column < ctx->column_width; column++) {
+      const uint16_t i = ((uint16_t)row * ctx->column_width) + column;
+      if (FB_BLANK == fb->shadow[i]) {
+        continue;
+      }
+      /* Address set is skipped inside a run of non blank cells */
+      ret = s_set_ddram_addr(ctx, s_cell_address(ctx, row, column));
+      if (HD44780_OK != ret) {
+        goto exit;
+      }
+      ret = s_write_data(ctx, FB_BLANK);
+      if (HD44780_OK != ret) {
+        goto exit;
+      }
+      fb->shadow[i] = FB_BLANK;
+    }
+  }
+  ret = s_set_ddram_addr(ctx, 0U);
+  ctx->state->cgram_visible = 0U;
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_clear(const hd44780_ctx* const ctx) { 
+  hd44780_ret_e ret = HD44780_OK;
+
+  if (s_smart_clear_pays_off(ctx)) {
+    ret = s_smart_clear(ctx);
+  } else {
+    ret = s_write_instruction(ctx, REG_CLEAR);
+    if ((HD44780_OK == ret) && (NULL != ctx->framebuffer)) {
+      memset(ctx->framebuffer->shadow, FB_BLANK, (size_t)ctx->number_of_lines * ctx->column_width);
+    }
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_write_run(const hd44780_ctx* const ctx, const uint8_t* data, size_t len) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  if ((NULL == ctx->cb_write_data_run) || HAS_QUEUE(ctx) || (len < 2U)) {
+    for (size_t i = 0U; (HD44780_OK == ret) && (i < len); i++) {
+      ret = s_write_data(ctx, data[i]);
+    }
+    goto exit;
+  }
+
+  /* Transport keeps bytes apart for execution time, only first one waits */
+  ret = s_wait_till_busy(ctx);
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+  s_config_bus_as_output(ctx);
+  ctx->cb_write_data_run(ctx, data, len, IS_4BIT(ctx));
+  TRACE(ctx, HD44780_TRACE_DATA_RUN, data[0], (uint16_t)len);
+  s_start_exec_time(ctx, EXEC_TIME_US);
+  for (size_t i = 0U; i < len; i++) {
+    s_track_data(ctx, data[i]);
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_write_text(const hd44780_ctx* const ctx, const char* text) {
+  return hd44780_write_buf(ctx, text, strlen(text));
+}
+
+hd44780_ret_e hd44780_write_buf(const hd44780_ctx* const ctx, const char* buf, size_t len) {
+  hd44780_ret_e ret = HD44780_OK;
+  const char* const end = buf + len;
+
+  while ((HD44780_OK == ret) && (buf < end)) {
+    /* ASCII codes are the same as display codes, whole run is sent as is */
+    const char* const run = buf;
+    while ((buf < end) && (0U == ((uint8_t)*buf & 0x80U))) {
+      buf++;
+    }
+    if (run != buf) {
+      ret = s_write_run(ctx, (const uint8_t*)run, (size_t)(buf - run));
+      continue;
+    }
+
+    uint8_t code = 0U;
+    ret = s_map_codepoint(ctx, s_decode_utf8(&buf, end), &code);
+    if (HD44780_OK == ret) {
+      ret = s_write_data(ctx, code);
+    }
+  }
+
+  return ret;
+}
+
+hd44780_ret_e hd44780_write_raw(const hd44780_ctx* const ctx, const uint8_t* buf, size_t len) {
+  return s_write_run(ctx, buf, len);
+}
+
+hd44780_ret_e hd44780_set_pos(const hd44780_ctx* const ctx, uint8_t row, uint8_t column) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  if ((ctx->column_width <= column) || (ctx->number_of_lines <= row)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  ret = s_set_ddram_addr(ctx, s_cell_address(ctx, row, column));
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_cursor_cfg(const hd44780_ctx* const ctx, hd44780_cursor cursor_cfg) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  /* Display on/off state is kept as it is */
+  uint8_t instruction = REG_PWR_AND_CURSOR | (ctx->state->display_ctrl & REG_DISPLAY_ON);
+  if (cursor_cfg == CURSOR_OFF) {
+    instruction |= REG_CURSOR_OFF;
+  } else if (cursor_cfg == CURSOR_ON) {
+    instruction |= REG_CURSOR_ON;
+  } else if (cursor_cfg == CURSOR_BLINK) {
+    instruction |= REG_CURSOR_ON | REG_CURSOR_BLINK;
+  } else {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+  ret = s_write_instruction(ctx, instruction);
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_init(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  if ((NULL == ctx->state) || (HAS_QUEUE(ctx) && (NULL == ctx->cb_get_time_us))) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+  /* Context has to agree with build time specialisation */
+  if ((IS_4BIT(ctx) != (INTERFACE_4BIT == ctx->interface)) || (IS_WRITE_ONLY(ctx) != ctx->write_only) ||
+      (HAS_QUEUE(ctx) != (NULL != ctx->queue))) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+  if (s_fb_frames_conflict(ctx)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+  memset(ctx->state, 0, sizeof(hd44780_state));
+  ctx->state->address = ADDR_UNKNOWN;
+  ctx->state->bus_direction = BUS_DIR_UNKNOWN;
+  if (NULL != ctx->framebuffer) {
+    /* Display content is unknown, smart clear must not be used */
+    ctx->framebuffer->stale = true;
+  }
+
+  ctx->cb_init_common();
+
+  if (!s_controller_set_up(ctx)) {
+    if (ctx->fast_init) {
+      ret = s_reset_sequence(ctx, DELAY_INIT_FAST_LONG_US, DELAY_INIT_FAST_SHORT_US);
+    } else {
+      ret = s_reset_sequence(ctx, DELAY_INIT_SEQ_LONG_MS * 1000UL, DELAY_INIT_SEQ_SHORT_MS * 1000UL);
+    }
+  }
+  if (HD44780_OK == ret) {
+    ret = s_write_instruction(ctx, REG_INTERFACE | REG_FONT_SIZE_5X8 | REG_TWO_LINES |
+                                   (IS_4BIT(ctx) ? REG_4_BIT_BUS : REG_8_BIT_BUS));
+  }
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+
+  ret = hd44780_display_off(ctx);
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+  ret = hd44780_clear(ctx);
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+  ret = s_write_instruction(ctx, REG_EM | REG_EM_SHIFT_CURSOR | REG_EM_INCREMENT);
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+  ret = hd44780_cursor_cfg(ctx, CURSOR_OFF);
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+  ret = s_upload_custom_chars(ctx);
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+  ret = hd44780_display_on(ctx);
+  if (HD44780_OK != ret) {
+    goto exit;
+  }
+  if (NULL != ctx->framebuffer) {
+    s_fb_frames_init(ctx);
+    ret = hd44780_fb_clear(ctx);
+    ctx->framebuffer->stale = false;
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_recover(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_state* const state = ctx->state;
+  const uint8_t ddram_address = s_ddram_address(ctx);
+  const uint8_t display_shift = state->display_shift;
+
+  state->recoveries++;
+  state->address = ADDR_UNKNOWN;
+  state->bus_direction = BUS_DIR_UNKNOWN;
+  state->exec_time_us = 0U;
+
+  /* Controller is running, so execution times suffice instead of power on delays.
+     First write might complete byte of lost nibble phase, in the worst case return home */
+  ret = s_init_delay_us(ctx, s_exec_time_us(ctx, EXEC_TIME_US));
+  if (HD44780_OK == ret) {
+    ret = s_reset_sequence(ctx, s_exec_time_us(ctx, EXEC_TIME_LONG_US), s_exec_time_us(ctx, EXEC_TIME_US));
+  }
+  if (HD44780_OK == ret) {
+    ret = s_write_instruction(ctx, REG_INTERFACE | REG_FONT_SIZE_5X8 | REG_TWO_LINES |
+                                   (IS_4BIT(ctx) ? REG_4_BIT_BUS : REG_8_BIT_BUS));
+  }
+  if ((HD44780_OK == ret) && (0U != state->entry_mode)) {
+    ret = s_write_instruction(ctx, state->entry_mode);
+  }
+  /* Stray byte might have shifted display back, shift is known again after return home */
+  if (HD44780_OK == ret) {
+    ret = s_write_instruction(ctx, REG_HOME);
+  }
+  if (HD44780_OK == ret) {
+    ret = hd44780_scroll(ctx, (display_shift <= (DDRAM_LINE_LEN / 2U)) ? (int8_t)display_shift :
+                                                                          (int8_t)(display_shift - DDRAM_LINE_LEN));
+  }
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < CGRAM_CHARS); i++) {
+    if (state->cgram_loaded & (1U << i)) {
+      ret = s_def_char(ctx, i, &state->cgram[i * 8U]);
+    }
+  }
+  if ((HD44780_OK == ret) && (NULL != ctx->framebuffer)) {
+    ctx->framebuffer->stale = true;
+    ret = hd44780_flush(ctx);
+  }
+  if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+    ret = s_set_ddram_addr(ctx, ddram_address);
+  }
+  if ((HD44780_OK == ret) && (0U != state->display_ctrl)) {
+    ret = s_write_instruction(ctx, state->display_ctrl);
+  }
+
+  return ret;
+}
+
+hd44780_ret_e hd44780_display_off(const hd44780_ctx* const ctx) {
+  const uint8_t cursor = ctx->state->display_ctrl & (REG_CURSOR_ON | REG_CURSOR_BLINK);
+  return s_write_instruction(ctx, REG_PWR_AND_CURSOR | REG_DISPLAY_OFF | cursor);
+}
+
+hd44780_ret_e hd44780_display_on(const hd44780_ctx* const ctx) {
+  const uint8_t cursor = ctx->state->display_ctrl & (REG_CURSOR_ON | REG_CURSOR_BLINK);
+  return s_write_instruction(ctx, REG_PWR_AND_CURSOR | REG_DISPLAY_ON | cursor);
+}
+
+hd44780_ret_e hd44780_def_char(const hd44780_ctx* const ctx, uint8_t index, const uint8_t* const pattern) {
+  const uint8_t ddram_address = s_ddram_address(ctx);
+  hd44780_ret_e ret = s_def_char(ctx, index, pattern);
+  if (index < CGRAM_CHARS) {
+    /* Character no longer holds any glyph of custom_chars_map */
+    ctx->state->cgram_glyph[index] = GLYPH_NONE;
+  }
+  if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+    ret = s_set_ddram_addr(ctx, ddram_address);
+  }
+  return ret;
+}
+
+hd44780_ret_e hd44780_def_char_diff(const hd44780_ctx* const ctx, uint8_t index, const uint8_t* const pattern) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_state* const state = ctx->state;
+  const uint8_t ddram_address = s_ddram_address(ctx);
+  bool written = false;
+
+  /* CGRAM mirror is valid only for characters defined since init */
+  if ((CGRAM_CHARS <= index) || (0U == (state->cgram_loaded & (1U << index))) ||
+      (0U == (state->entry_mode & REG_EM_INCREMENT))) {
+    ret = hd44780_def_char(ctx, index, pattern);
+    goto exit;
+  }
+
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < 8U); i++) {
+    const uint8_t address = (uint8_t)((index * 8U) + i);
+    if (state->cgram[address] == pattern[i]) {
+      STATS_ADD(ctx, diff_saved, 1U);
+      continue;
+    }
+    if ((!state->cgram_selected) || (address != state->address)) {
+      ret = s_set_cgram_addr(ctx, address);
+    }
+    if (HD44780_OK == ret) {
+      ret = s_write_data(ctx, pattern[i]);
+    }
+    written = true;
+  }
+  if (written) {
+    state->cgram_glyph[index] = GLYPH_NONE;
+    STATS_ADD(ctx, cgram_uploads, 1U);
+    if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+      ret = s_set_ddram_addr(ctx, ddram_address);
+    }
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_disp_char(const hd44780_ctx* const ctx, uint8_t const index) {
+  return s_write_data(ctx, index);
+}
+
+hd44780_ret_e hd44780_read_ddram(const hd44780_ctx* const ctx, uint8_t address, uint8_t* buf, size_t len) {
+  hd44780_ret_e ret = HD44780_OK;
+  const uint8_t ddram_address = s_ddram_address(ctx);
+
+  if (IS_WRITE_ONLY(ctx) || HAS_QUEUE(ctx)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  ret = s_read_run(ctx, REG_DDRAM_ADDR_SET | (address & (uint8_t)(~REG_DDRAM_ADDR_SET)), buf, len);
+  if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+    ret = s_set_ddram_addr(ctx, ddram_address);
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_read_cgram(const hd44780_ctx* const ctx, uint8_t address, uint8_t* buf, size_t len) {
+  hd44780_ret_e ret = HD44780_OK;
+  const uint8_t ddram_address = s_ddram_address(ctx);
+
+  if (IS_WRITE_ONLY(ctx) || HAS_QUEUE(ctx)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  ret = s_read_run(ctx, REG_CGRAM_ADDR_SET | (address & CGRAM_ADDR_MASK), buf, len);
+  if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+    ret = s_set_ddram_addr(ctx, ddram_address);
+  }
+
+exit:
+  return ret;
+}
+
+bool hd44780_is_busy(const hd44780_ctx* const ctx)
+{
+  bool ret = false;
+
+  if (IS_WRITE_ONLY(ctx)) {
+    ret = (0U != s_exec_time_remaining(ctx));
+  } else if (s_read_address(ctx) & 0x80) {
+    ret = true;
+  }
+
+  return ret;
+}
+
+hd44780_ret_e hd44780_fb_set_pos(const hd44780_ctx* const ctx, uint8_t row, uint8_t column) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  if ((NULL == ctx->framebuffer) || (ctx->column_width <= column) || (ctx->number_of_lines <= row)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  ctx->framebuffer->row = row;
+  ctx->framebuffer->column = column;
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_fb_write_text(const hd44780_ctx* const ctx, const char* text) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_fb* const fb = ctx->framebuffer;
+
+  if (NULL == fb) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  const char* const end = text + strlen(text);
+  while ((HD44780_OK == ret) && (text < end)) {
+    ret = s_fb_put(ctx, s_decode_utf8(&text, end));
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_printf_at(const hd44780_ctx* const ctx, uint8_t row, uint8_t column, const char* fmt, ...) {
+  hd44780_ret_e ret = hd44780_fb_set_pos(ctx, row, column);
+  const char* const end = fmt + strlen(fmt);
+  va_list args;
+
+  va_start(args, fmt);
+  while ((HD44780_OK == ret) && (fmt < end)) {
+    if ('%' != *fmt) {
+      ret = s_fb_put(ctx, s_decode_utf8(&fmt, end));
+      continue;
+    }
+
+    uint8_t flags = 0U;
+    uint8_t width = 0U;
+    uint8_t precision = FMT_NO_PRECISION;
+    bool is_long = false;
+    for (fmt++; ('-' == *fmt) || ('0' == *fmt); fmt++) {
+      flags |= ('-' == *fmt) ? FMT_LEFT : FMT_ZERO;
+    }
+    if (!s_fmt_field(&fmt, ctx->column_width, &width)) {
+      ret = HD44780_INV_ARG;
+      break;
+    }
+    if ('.' == *fmt) {
+      fmt++;
+      if (!s_fmt_field(&fmt, ctx->column_width, &precision)) {
+        ret = HD44780_INV_ARG;
+        break;
+      }
+    }
+    if ('l' == *fmt) {
+      is_long = true;
+      fmt++;
+    }
+    const uint8_t decimals = (FMT_NO_PRECISION == precision) ? 0U : precision;
+
+    switch (*fmt) {
+      case 'd':
+      case 'i': {
+        const long value = is_long ? va_arg(args, long) : (long)va_arg(args, int);
+        const unsigned long magnitude = (value < 0) ? (0UL - (unsigned long)value) : (unsigned long)value;
+        ret = s_fb_put_number(ctx, magnitude, (value < 0), 10U, width, decimals, flags);
+        break;
+      }
+      case 'u':
+      case 'x':
+      case 'X': {
+        const unsigned long value = is_long ? va_arg(args, unsigned long) : (unsigned long)va_arg(args, unsigned int);
+        flags |= ('X' == *fmt) ? FMT_UPPER : 0U;
+        ret = s_fb_put_number(ctx, value, false, ('u' == *fmt) ? 10U : 16U, width, ('u' == *fmt) ? decimals : 0U, flags);
+        break;
+      }
+      case 's': {
+        const char* const text = va_arg(args, const char*);
+        ret = s_fb_put_text(ctx, (NULL != text) ? text : "(null)", width, precision, flags);
+        break;
+      }
+      case 'c': {
+        const char text[2] = { (char)va_arg(args, int), '\0' };
+        ret = s_fb_put_text(ctx, text, width, FMT_NO_PRECISION, flags);
+        break;
+      }
+      case '%':
+        ret = s_fb_put(ctx, '%');
+        break;
+      default:
+        ret = HD44780_INV_ARG;
+        break;
+    }
+    fmt++;
+  }
+  va_end(args);
+
+  return ret;
+}
+
+hd44780_ret_e hd44780_fb_write_raw(const hd44780_ctx* const ctx, const uint8_t* buf, size_t len) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_fb* const fb = ctx->framebuffer;
+
+  if (NULL == fb) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  uint8_t* const target = s_fb_target(fb);
+  for (size_t i = 0U; (i < len) && (fb->column < ctx->column_width); i++) {
+    target[(fb->row * ctx->column_width) + fb->column] = buf[i];
+    fb->column++;
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_fb_clear(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  if (NULL == ctx->framebuffer) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  memset(s_fb_target(ctx->framebuffer), FB_BLANK, (size_t)ctx->number_of_lines * ctx->column_width);
+  ctx->framebuffer->row = 0U;
+  ctx->framebuffer->column = 0U;
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_fb_invalidate(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  if (NULL == ctx->framebuffer) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  ctx->framebuffer->stale = true;
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_fb_publish(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_fb* const fb = ctx->framebuffer;
+
+  if ((NULL == fb) || (!HAS_FRAMES(fb))) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  /* Display task might take ready frame at the same time */
+  uint8_t swap = __atomic_load_n(&fb->swap, __ATOMIC_RELAXED);
+  uint8_t published = 0U;
+  do {
+    published = FB_SWAP_BACK(swap);
+  } while (!__atomic_compare_exchange_n(&fb->swap, &swap,
+                                        FB_SWAP(FB_SWAP_READY(swap), published, FB_SWAP_FRONT(swap)) | FB_SWAP_FRESH,
+                                        true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+  /* Published frame is only read from now on, render continues on its copy */
+  memcpy(fb->frames[FB_SWAP_READY(swap)], fb->frames[published], (size_t)ctx->number_of_lines * ctx->column_width);
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_flush(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_fb* const fb = ctx->framebuffer;
+  bool batch = false;
+
+  if (NULL == fb) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+  s_fb_acquire(fb);
+
+  if (IS_WRITE_ONLY(ctx) && (!HAS_QUEUE(ctx)) && (NULL != ctx->cb_flush_begin)) {
+    /* Last write before batch is still timed by driver */
+    ret = s_wait_till_busy(ctx);
+    if (HD44780_OK != ret) {
+      goto exit;
+    }
+    ctx->cb_flush_begin(ctx);
+    ctx->state->paced = true;
+    batch = true;
+  }
+
+  for (uint8_t n = 0U; n < ctx->number_of_lines; n++) {
+    const uint8_t row = s_row_in_address_order(ctx, n);
+    const uint8_t* const cells = &fb->cells[(uint16_t)row * ctx->column_width];
+    uint8_t* const shadow = &fb->shadow[(uint16_t)row * ctx->column_width];
+    uint8_t column = 0U;
+    while (column < ctx->column_width) {
+      if ((!fb->stale) && (cells[column] == shadow[column])) {
+        STATS_ADD(ctx, diff_saved, 1U);
+        column++;
+        continue;
+      }
+
+      /* Gap of one unchanged cell is rewritten, it costs as much as address set */
+      uint8_t end = column + 1U;
+      while (end < ctx->column_width) {
+        if (fb->stale || (cells[end] != shadow[end])) {
+          end++;
+        } else if (((end + 1U) < ctx->column_width) && (cells[end + 1U] != shadow[end + 1U])) {
+          end += 2U;
+        } else {
+          break;
+        }
+      }
+
+      ret = s_set_ddram_addr(ctx, s_cell_address(ctx, row, column));
+      if (HD44780_OK == ret) {
+        ret = s_write_run(ctx, &cells[column], end - column);
+      }
+      if (HD44780_OK != ret) {
+        goto exit;
+      }
+      memcpy(&shadow[column], &cells[column], end - column);
+      column = end;
+    }
+  }
+  fb->stale = false;
+
+exit:
+  if (batch) {
+    /* Transport keeps last write apart from following one as well */
+    ctx->state->paced = false;
+    ctx->state->exec_time_us = 0U;
+    ctx->cb_flush_end(ctx);
+  }
+  return ret;
+}
+
+hd44780_ret_e hd44780_scrub(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_state* const state = ctx->state;
+  const hd44780_fb* const fb = ctx->framebuffer;
+  const uint8_t ddram_address = s_ddram_address(ctx);
+  uint8_t readback[CGRAM_CHARS * 8U];
+
+  if ((NULL == fb) || IS_WRITE_ONLY(ctx) || HAS_QUEUE(ctx)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+  if (fb->stale) {
+    goto exit;
+  }
+
+  const uint8_t row = (state->scrub_row < ctx->number_of_lines) ? state->scrub_row : ctx->number_of_lines;
+  state->scrub_row = (row < ctx->number_of_lines) ? (uint8_t)(row + 1U) : 0U;
+
+  if (row < ctx->number_of_lines) {
+    const uint8_t* const shadow = &fb->shadow[(uint16_t)row * ctx->column_width];
+    const uint8_t width = (ctx->column_width < DDRAM_LINE_LEN) ? ctx->column_width : DDRAM_LINE_LEN;
+    ret = s_read_run(ctx, REG_DDRAM_ADDR_SET | s_cell_address(ctx, row, 0U), readback, width);
+    uint8_t column = 0U;
+    while ((HD44780_OK == ret) && (column < width)) {
+      if (readback[column] == shadow[column]) {
+        column++;
+        continue;
+      }
+      uint8_t end = column + 1U;
+      while ((end < width) && (readback[end] != shadow[end])) {
+        end++;
+      }
+      ret = s_set_ddram_addr(ctx, s_cell_address(ctx, row, column));
+      if (HD44780_OK == ret) {
+        ret = s_write_run(ctx, &shadow[column], end - column);
+      }
+      state->scrub_repairs += (uint16_t)(end - column);
+      column = end;
+    }
+  } else {
+    ret = s_read_run(ctx, REG_CGRAM_ADDR_SET, readback, sizeof(readback));
+    for (uint8_t i = 0U; (HD44780_OK == ret) && (i < CGRAM_CHARS); i++) {
+      const uint8_t* const expected = &state->cgram[i * 8U];
+      bool equal = true;
+      for (uint8_t r = 0U; r < 8U; r++) {
+        /* Only 5 lower bits are implemented in CGRAM */
+        equal = equal && (0U == ((readback[(i * 8U) + r] ^ expected[r]) & 0x1FU));
+      }
+      if ((0U != (state->cgram_loaded & (1U << i))) && (!equal)) {
+        ret = s_def_char(ctx, i, expected);
+        state->scrub_repairs++;
+      }
+    }
+  }
+  if ((HD44780_OK == ret) && (ADDR_UNKNOWN != ddram_address)) {
+    ret = s_set_ddram_addr(ctx, ddram_address);
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_wait_while_busy(const hd44780_ctx* const ctx)
+{
+  hd44780_ret_e ret = HD44780_TIMEOUT;
+  hd44780_state* const state = ctx->state;
+  const uint32_t timeout_us = HD44780_TIMEOUT_MS * 1000UL;
+  const uint32_t start_us = (NULL != ctx->cb_get_time_us) ? ctx->cb_get_time_us() : 0U;
+  const uint32_t expect_us = state->poll_expect_us;
+  /* Between expected time and the one of slow oscillator polls are frequent */
+  const uint32_t tolerance_us = (expect_us * HD44780_EXEC_TIME_SCALE_PCT) / 100U;
+  uint32_t spent_us = 0U;
+  uint32_t elapsed_us = 0U;
+  uint16_t backoff_us = HD44780_POLL_BACKOFF_MIN_US;
+
+  state->poll_expect_us = 0U;
+  if ((NULL != ctx->cb_busy_wait_begin) && (NULL != ctx->cb_busy_wait_signalled)) {
+    ret = s_wait_busy_irq(ctx);
+    goto exit;
+  }
+  if ((0U != expect_us) && (NULL != ctx->cb_get_time_us)) {
+    spent_us = start_us - state->exec_start_us;
+  }
+
+  while (elapsed_us <= timeout_us) {
+    const uint32_t since_write_us = spent_us + elapsed_us;
+    uint32_t wait_us = backoff_us;
+    if ((since_write_us >= expect_us) && !(hd44780_is_busy(ctx))) {
+      ret = HD44780_OK;
+      break;
+    }
+    if (since_write_us < expect_us) {
+      /* Nothing to poll for before the write is expected to complete */
+      wait_us = expect_us - since_write_us;
+    } else if (since_write_us < tolerance_us) {
+      wait_us = HD44780_POLL_BACKOFF_MIN_US;
+    } else if (backoff_us < HD44780_POLL_BACKOFF_MAX_US) {
+      backoff_us = (uint16_t)(((2U * backoff_us) < HD44780_POLL_BACKOFF_MAX_US) ? (2U * backoff_us) : HD44780_POLL_BACKOFF_MAX_US);
+    }
+    elapsed_us += s_poll_backoff(ctx, (uint16_t)wait_us);
+    if (NULL != ctx->cb_get_time_us) {
+      elapsed_us = ctx->cb_get_time_us() - start_us;
+    }
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_tick(const hd44780_ctx* const ctx) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_state* const state = ctx->state;
+  const uint16_t tail = state->queue_tail;
+  const bool idle = (tail == state->queue_head);
+  uint8_t anim_step = ANIM_STEP_NONE;
+  hd44780_op op = { 0U };
+
+  if ((!HAS_QUEUE(ctx)) || (idle && (NULL == state->anims) && (0U == state->anim_return))) {
+    goto exit;
+  }
+
+  /* Delay or write only mode execution time */
+  if (0U != s_exec_time_remaining(ctx)) {
+    goto exit;
+  }
+  state->exec_time_us = 0U;
+
+  if (idle || (0U != state->anim_return)) {
+    /* Animation runs only while queue is empty and gives address back before queued operation */
+    anim_step = s_anim_next(ctx, idle, &op);
+    if (ANIM_STEP_NONE == anim_step) {
+      goto exit;
+    }
+  } else {
+    const volatile hd44780_op* const queued = &ctx->queue[tail];
+    op.kind = queued->kind;
+    op.data = queued->data;
+    op.time_us = queued->time_us;
+  }
+  const bool bus_write = (OP_INSTRUCTION == op.kind) || (OP_DATA == op.kind);
+  if (bus_write && (!IS_WRITE_ONLY(ctx)) && hd44780_is_busy(ctx)) {
+    if ((ctx->cb_get_time_us() - state->exec_start_us) > (HD44780_TIMEOUT_MS * 1000UL)) {
+      state->queue_tail = state->queue_head;
+      ret = HD44780_TIMEOUT;
+      STATS_ADD(ctx, timeouts, 1U);
+    }
+    goto exit;
+  }
+
+  state->exec_start_us = ctx->cb_get_time_us();
+  switch (op.kind) {
+    case OP_INSTRUCTION:
+      s_send_instruction(ctx, op.data);
+      break;
+    case OP_DATA:
+      s_send_data(ctx, op.data);
+      break;
+    case OP_NIBBLE:
+      s_send_init_instruction(ctx, op.data);
+      break;
+    case OP_DELAY:
+      state->exec_time_us = op.time_us;
+      break;
+    case OP_NOTIFY:
+      if (NULL != ctx->cb_async_done) {
+        ctx->cb_async_done(ctx, op.data);
+      }
+      break;
+    default:
+      break;
+  }
+  if (ANIM_STEP_NONE != anim_step) {
+    s_anim_commit(ctx, anim_step, &op);
+  } else {
+    state->queue_tail = ((tail + 1U) < ctx->queue_len) ? (tail + 1U) : 0U;
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_async_notify(const hd44780_ctx* const ctx, uint8_t tag) {
+  hd44780_ret_e ret = HD44780_INV_ARG;
+  if (HAS_QUEUE(ctx)) {
+    ret = s_enqueue(ctx, OP_NOTIFY, tag, 0U);
+  }
+  return ret;
+}
+
+bool hd44780_async_idle(const hd44780_ctx* const ctx) {
+  return (!HAS_QUEUE(ctx)) || (ctx->state->queue_head == ctx->state->queue_tail);
+}
+
+hd44780_ret_e hd44780_anim_start(const hd44780_ctx* const ctx, hd44780_anim* const anim) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_state* const state = ctx->state;
+
+  if ((!HAS_QUEUE(ctx)) || (CGRAM_CHARS <= anim->index) || (NULL == anim->frames) || (0U == anim->frames_len)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  anim->frame = 0U;
+  anim->row = 0U;
+  anim->due_us = ctx->cb_get_time_us() + (anim->period_ms * 1000UL);
+  /* Character is not defined by custom_chars_map or glyph cache any more */
+  state->cgram_glyph[anim->index] = GLYPH_NONE;
+  if (0U == (state->cgram_loaded & (1U << anim->index))) {
+    /* CGRAM content is unknown, first frame is written whole */
+    for (uint8_t i = 0U; i < 8U; i++) {
+      state->cgram[(anim->index * 8U) + i] = (uint8_t)(~anim->frames[0].character_bitmap[i]);
+    }
+    state->cgram_loaded |= (uint8_t)(1U << anim->index);
+  }
+  /* Tick walks the list, it sees either old head or complete element */
+  anim->next = state->anims;
+  __atomic_store_n(&state->anims, anim, __ATOMIC_RELEASE);
+
+exit:
+  return ret;
+}
+
+void hd44780_anim_stop(const hd44780_ctx* const ctx, hd44780_anim* const anim) {
+  hd44780_anim** link = &ctx->state->anims;
+  while ((NULL != *link) && (anim != *link)) {
+    link = &(*link)->next;
+  }
+  if (NULL != *link) {
+    __atomic_store_n(link, anim->next, __ATOMIC_RELEASE);
+  }
+}
+
+static hd44780_cmd* s_ring_reserve(hd44780_cmd_ring* const ring) {
+  hd44780_cmd* slot = NULL;
+  uint32_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+  /* Slot is free when its sequence number equals position, see Vyukov bounded queue */
+  while (NULL == slot) {
+    hd44780_cmd* const candidate = &ring->slots[pos & RING_MASK];
+    const int32_t diff = (int32_t)(RING_LOAD(&candidate->seq) - pos);
+    if (diff < 0) {
+      break;
+    } else if (diff > 0) {
+      pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    } else {
+#if (HD44780_CMD_RING_MPSC)
+      if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1U, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        slot = candidate;
+      }
+#else
+      __atomic_store_n(&ring->head, pos + 1U, __ATOMIC_RELAXED);
+      slot = candidate;
+#endif
+    }
+  }
+
+  return slot;
+}
+
+static void s_ring_commit(hd44780_cmd* const slot) {
+  RING_STORE(&slot->seq, slot->seq + 1U);
+}
+
+static hd44780_ret_e s_cmd_execute(const hd44780_ctx* const ctx, const hd44780_cmd* const cmd) {
+  hd44780_ret_e ret = HD44780_OK;
+  const bool fb = (NULL != ctx->framebuffer);
+
+  switch (cmd->kind) {
+    case CMD_TEXT:
+      ret = fb ? hd44780_fb_set_pos(ctx, cmd->row, cmd->column) : hd44780_set_pos(ctx, cmd->row, cmd->column);
+      if (HD44780_OK == ret) {
+        ret = fb ? hd44780_fb_write_text(ctx, cmd->text) : hd44780_write_text(ctx, cmd->text);
+      }
+      break;
+    case CMD_CLEAR:
+      ret = fb ? hd44780_fb_clear(ctx) : hd44780_clear(ctx);
+      break;
+    case CMD_CURSOR:
+      ret = hd44780_set_pos(ctx, cmd->row, cmd->column);
+      if (HD44780_OK == ret) {
+        ret = hd44780_cursor_cfg(ctx, (hd44780_cursor)cmd->arg);
+      }
+      break;
+    default:
+      ret = HD44780_INV_ARG;
+      break;
+  }
+
+  return ret;
+}
+
+void hd44780_cmd_ring_init(hd44780_cmd_ring* const ring) {
+  for (uint32_t i = 0U; i < HD44780_CMD_RING_LEN; i++) {
+    ring->slots[i].seq = i;
+  }
+  ring->head = 0U;
+  ring->tail = 0U;
+}
+
+hd44780_ret_e hd44780_cmd_post_text(hd44780_cmd_ring* const ring, uint8_t row, uint8_t column, const char* text) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_cmd* const slot = s_ring_reserve(ring);
+
+  if (NULL == slot) {
+    ret = HD44780_QUEUE_FULL;
+    goto exit;
+  }
+
+  size_t len = strlen(text);
+  if (len >= HD44780_CMD_TEXT_LEN) {
+    len = HD44780_CMD_TEXT_LEN - 1U;
+    /* Do not split UTF-8 character, continuation bytes are 10xxxxxx */
+    while ((0U < len) && (0x80U == ((uint8_t)text[len] & 0xC0U))) {
+      len--;
+    }
+  }
+  memcpy(slot->text, text, len);
+  slot->text[len] = '\0';
+  slot->kind = CMD_TEXT;
+  slot->row = row;
+  slot->column = column;
+  s_ring_commit(slot);
+
+exit:
   return ret;
 }
 
-/* "Public" functions implementation */
+hd44780_ret_e hd44780_cmd_post_clear(hd44780_cmd_ring* const ring) {
+  hd44780_ret_e ret = HD44780_OK;
+  hd44780_cmd* const slot = s_ring_reserve(ring);
 
-hd44780_ret_e hd44780_clear(const hd44780_ctx* const ctx) { 
-  return s_write_instruction(ctx, REG_CLEAR); 
+  if (NULL == slot) {
+    ret = HD44780_QUEUE_FULL;
+    goto exit;
+  }
+
+  slot->kind = CMD_CLEAR;
+  s_ring_commit(slot);
+
+exit:
+  return ret;
 }
 
-hd44780_ret_e hd44780_write_text(const hd44780_ctx* const ctx, const char* text) {
+hd44780_ret_e hd44780_cmd_post_cursor(hd44780_cmd_ring* const ring, uint8_t row, uint8_t column, hd44780_cursor cursor_cfg) {
   hd44780_ret_e ret = HD44780_OK;
+  hd44780_cmd* const slot = s_ring_reserve(ring);
 
-  while ((HD44780_OK == ret) && (*text)) {
-    uint32_t codepoint = 0U;
-    if (*text <= 0x7f) {
-        // Pure ASCII character
-        ret = s_write_data(ctx, *text++);
-        continue;
-    } else if (*text <= 0xDF) {
-        // Two byte UTF-8 character
-        codepoint  = (*text++ & 0x1F) << 6;
-        codepoint |= (*text++ & 0x3F);
-    } else if (*text <= 0xEF) {
-        // Three byte UTF-8 character
-        codepoint  = (*text++ & 0x0F) << 12;
-        codepoint |= (*text++ & 0x3F) << 6;
-        codepoint |= (*text++ & 0x3F);
+  if (NULL == slot) {
+    ret = HD44780_QUEUE_FULL;
+    goto exit;
+  }
+
+  slot->kind = CMD_CURSOR;
+  slot->row = row;
+  slot->column = column;
+  slot->arg = (uint8_t)cursor_cfg;
+  s_ring_commit(slot);
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_cmd_process(const hd44780_ctx* const ctx, hd44780_cmd_ring* const ring) {
+  hd44780_ret_e ret = HD44780_OK;
+  bool rendered = false;
+  hd44780_cmd cursor = { .kind = CMD_TEXT };
+
+  while (true) {
+    hd44780_cmd* const slot = &ring->slots[ring->tail & RING_MASK];
+    if (RING_LOAD(&slot->seq) != (ring->tail + 1U)) {
+      break;
+    }
+
+    hd44780_ret_e cmd_ret = HD44780_OK;
+    if ((CMD_CURSOR == slot->kind) && (NULL != ctx->framebuffer)) {
+      /* Flush moves display address, cursor is placed after it */
+      cursor = *slot;
     } else {
-        // Four byte UTF-8 character
-        codepoint  = (*text++ & 0x07) << 18;
-        codepoint |= (*text++ & 0x3F) << 12;
-        codepoint |= (*text++ & 0x3F) << 6;
-        codepoint |= (*text++ & 0x3F);
+      cmd_ret = s_cmd_execute(ctx, slot);
+      rendered = true;
+    }
+    if (HD44780_OK == ret) {
+      ret = cmd_ret;
     }
 
-    uint8_t custom_char_index = 0;
-    ret = s_find_character_by_code(ctx, codepoint, &custom_char_index);
+    /* Slot becomes free for position one lap ahead */
+    RING_STORE(&slot->seq, ring->tail + HD44780_CMD_RING_LEN);
+    ring->tail++;
+  }
+
+  if (rendered && (NULL != ctx->framebuffer)) {
+    if (HAS_FRAMES(ctx->framebuffer)) {
+      (void)hd44780_fb_publish(ctx);
+    }
+    const hd44780_ret_e flush_ret = hd44780_flush(ctx);
+    if (HD44780_OK == ret) {
+      ret = flush_ret;
+    }
+  }
+  if (CMD_CURSOR == cursor.kind) {
+    const hd44780_ret_e cursor_ret = s_cmd_execute(ctx, &cursor);
     if (HD44780_OK == ret) {
-      uint32_t address = s_read_address(ctx);
-      hd44780_disp_char(ctx, custom_char_index);
-      s_set_ddram_addr(ctx, (++address));
+      ret = cursor_ret;
+    }
+  }
+
+  return ret;
+}
+
+static bool s_group_valid(const hd44780_group* const group) {
+  bool valid = (0U < group->members_len) && (group->members_len <= HD44780_GROUP_MAX_MEMBERS);
+  const hd44780_ctx* const first = valid ? group->members[0] : NULL;
+
+  for (uint8_t m = 0U; valid && (m < group->members_len); m++) {
+    const hd44780_ctx* const ctx = group->members[m];
+    valid = (NULL != ctx->framebuffer) && (!HAS_QUEUE(ctx)) &&
+            (ctx->number_of_lines == first->number_of_lines) && (ctx->column_width == first->column_width);
+  }
+  if (valid && (NULL != group->broadcast)) {
+    valid = group->broadcast->write_only && (!HAS_QUEUE(group->broadcast));
+  }
+  return valid;
+}
+
+static hd44780_ret_e s_group_broadcast_cells(const hd44780_group* const group) {
+  hd44780_ret_e ret = HD44780_OK;
+  const hd44780_ctx* const bc = group->broadcast;
+  const hd44780_ctx* const first = group->members[0];
+  bool written = false;
+
+  /* Since last broadcast members moved their address counters (flush, direct writes) */
+  bc->state->address = ADDR_UNKNOWN;
+
+  for (uint8_t n = 0U; n < first->number_of_lines; n++) {
+    const uint8_t row = s_row_in_address_order(first, n);
+    for (uint8_t column = 0U; column < first->column_width; column++) {
+      const uint16_t i = ((uint16_t)row * first->column_width) + column;
+      const uint8_t cell = first->framebuffer->cells[i];
+      bool equal = true;
+      bool changed = false;
+      for (uint8_t m = 0U; equal && (m < group->members_len); m++) {
+        const hd44780_fb* const fb = group->members[m]->framebuffer;
+        equal = (fb->cells[i] == cell);
+        changed |= (fb->stale || (fb->shadow[i] != cell));
+      }
+      if ((!equal) || (!changed)) {
+        continue;
+      }
+
+      if (!written) {
+        /* Members may still execute their own writes, broadcast reaches every controller */
+        for (uint8_t m = 0U; (HD44780_OK == ret) && (m < group->members_len); m++) {
+          hd44780_bus_invalidate(group->members[m]);
+          ret = s_wait_till_busy(group->members[m]);
+        }
+        hd44780_bus_invalidate(bc);
+        written = true;
+      }
+      if (HD44780_OK == ret) {
+        ret = s_set_ddram_addr(bc, s_cell_address(bc, row, column));
+      }
+      if (HD44780_OK == ret) {
+        ret = s_write_data(bc, cell);
+      }
+      if (HD44780_OK != ret) {
+        goto exit;
+      }
+      for (uint8_t m = 0U; m < group->members_len; m++) {
+        group->members[m]->framebuffer->shadow[i] = cell;
+      }
     }
   }
 
 exit:
+  if (written) {
+    /* Members did not see their address counters move, last write has to be executed */
+    s_wait_exec_time(bc);
+    for (uint8_t m = 0U; m < group->members_len; m++) {
+      group->members[m]->state->address = ADDR_UNKNOWN;
+    }
+  }
   return ret;
 }
 
-hd44780_ret_e hd44780_set_pos(const hd44780_ctx* const ctx, uint8_t row, uint8_t column) {
+static hd44780_ret_e s_flush_step(const hd44780_ctx* const ctx, uint16_t* const pos, bool* const done) {
   hd44780_ret_e ret = HD44780_OK;
+  hd44780_fb* const fb = ctx->framebuffer;
+  const uint16_t cells = (uint16_t)ctx->number_of_lines * ctx->column_width;
+
+  while (*pos < cells) {
+    const uint8_t row = s_row_in_address_order(ctx, (uint8_t)(*pos / ctx->column_width));
+    const uint8_t column = (uint8_t)(*pos % ctx->column_width);
+    const uint16_t i = ((uint16_t)row * ctx->column_width) + column;
+    if ((!fb->stale) && (fb->cells[i] == fb->shadow[i])) {
+      STATS_ADD(ctx, diff_saved, 1U);
+      (*pos)++;
+      continue;
+    }
 
-  if ((ctx->column_width <= column) || (ctx->number_of_lines <= row)) {
-    ret = HD44780_INV_ARG;
+    const uint8_t address = s_ddram_address(ctx);
+    const uint8_t cell_address = s_cell_address(ctx, row, column);
+    if (cell_address == address) {
+      ret = s_write_data(ctx, fb->cells[i]);
+      if (HD44780_OK == ret) {
+        fb->shadow[i] = fb->cells[i];
+        (*pos)++;
+      }
+    } else if ((0U < column) && ((uint8_t)(address + 1U) == cell_address)) {
+      /* Gap of one unchanged cell, rewriting it costs as much as address set */
+      ret = s_write_data(ctx, fb->cells[i - 1U]);
+      STATS_SUB(ctx, diff_saved, 1U);
+    } else {
+      ret = s_set_ddram_addr(ctx, cell_address);
+    }
     goto exit;
   }
+  fb->stale = false;
+  *done = true;
 
-  uint8_t address = column;
-  switch (row) {
-    case 1:
-      address += 0x40U;
-      break;
-    case 2:
-      address += ctx->column_width;
-      break;
-    case 3:
-      address += 0x40U;
-      address += ctx->column_width;
-      break;
-    case 0: /* intentionally fallthrough */
-    default:
-      break;
+exit:
+  return ret;
+}
+
+static hd44780_ret_e s_marquee_fill(const hd44780_ctx* const ctx, hd44780_marquee* const marquee, uint8_t column, uint8_t count) {
+  hd44780_ret_e ret = HD44780_OK;
+  const uint8_t line = (0U < marquee->row) ? DDRAM_LINE_2_START : 0U;
+  const char* const end = marquee->text + strlen(marquee->text);
+
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < count); i++) {
+    /* Address counter passes to the other line after column 39 */
+    ret = s_set_ddram_addr(ctx, line + ((column + i) % DDRAM_LINE_LEN));
+    if (HD44780_OK == ret) {
+      uint8_t code = 0U;
+      ret = s_map_codepoint(ctx, s_decode_utf8(&marquee->next, end), &code);
+      if (HD44780_OK == ret) {
+        ret = s_write_data(ctx, code);
+      }
+    }
+    if ('\0' == *marquee->next) {
+      marquee->next = marquee->text;
+    }
   }
+  return ret;
+}
 
-  ret = s_set_ddram_addr(ctx, address);
+hd44780_ret_e hd44780_scroll(const hd44780_ctx* const ctx, int8_t columns) {
+  hd44780_ret_e ret = HD44780_OK;
+  const uint8_t instruction = REG_DISPLAY_SHIFT | REG_SHIFT_DISPLAY | ((columns < 0) ? REG_SHIFT_RIGHT : REG_SHIFT_LEFT);
+  const uint8_t count = (uint8_t)((columns < 0) ? -columns : columns);
 
-exit:
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < count); i++) {
+    ret = s_write_instruction(ctx, instruction);
+  }
   return ret;
 }
 
-hd44780_ret_e hd44780_cursor_cfg(const hd44780_ctx* const ctx, hd44780_cursor cursor_cfg) {
+hd44780_ret_e hd44780_marquee_start(const hd44780_ctx* const ctx, hd44780_marquee* const marquee) {
   hd44780_ret_e ret = HD44780_OK;
 
-  uint8_t instruction = REG_PWR_AND_CURSOR | REG_DISPLAY_ON;
-  if (cursor_cfg == CURSOR_OFF) {
-    instruction |= REG_CURSOR_OFF;
-  } else if (cursor_cfg == CURSOR_ON) {
-    instruction |= REG_CURSOR_ON;
-  } else if (cursor_cfg == CURSOR_BLINK) {
-    instruction |= REG_CURSOR_ON | REG_CURSOR_BLINK;
-  } else {
+  if ((2U < ctx->number_of_lines) || (ctx->number_of_lines <= marquee->row) || (NULL == marquee->text) ||
+      ('\0' == marquee->text[0]) || (DDRAM_LINE_LEN < ctx->column_width)) {
     ret = HD44780_INV_ARG;
     goto exit;
   }
-  ret = s_write_instruction(ctx, instruction);
+
+  if (0U != ctx->state->display_shift) {
+    ret = s_write_instruction(ctx, REG_HOME);
+    if (HD44780_OK != ret) {
+      goto exit;
+    }
+  }
+  marquee->next = marquee->text;
+  marquee->ahead = DDRAM_LINE_LEN - ctx->column_width;
+  ret = s_marquee_fill(ctx, marquee, 0U, DDRAM_LINE_LEN);
 
 exit:
   return ret;
 }
 
-hd44780_ret_e hd44780_init(const hd44780_ctx* const ctx) {
+hd44780_ret_e hd44780_marquee_step(const hd44780_ctx* const ctx, hd44780_marquee* const marquee) {
   hd44780_ret_e ret = HD44780_OK;
-  ctx->cb_init_common();
-  ctx->cb_set_ctrl_pin_state(HD44780_PIN_RS, PIN_RESET);
-
-  s_write_operation(ctx, REG_INTERFACE | REG_8_BIT_BUS);
-  ctx->cb_delay_ms(DELAY_INIT_SEQ_LONG_MS);
-  for (uint8_t i = 0U; i < 2U; i++) {
-    s_write_operation(ctx, REG_INTERFACE | REG_8_BIT_BUS);
-    ctx->cb_delay_ms(DELAY_INIT_SEQ_SHORT_MS);
-  }
 
-  if (ctx->interface == INTERFACE_8BIT) {
-    s_write_operation(ctx, REG_INTERFACE | REG_FONT_SIZE_5X8 | REG_TWO_LINES | REG_8_BIT_BUS);
-  } else {
-    s_write_operation(ctx, REG_INTERFACE | REG_4_BIT_BUS);
-    ctx->cb_delay_ms(DELAY_INIT_SEQ_SHORT_MS);
-    ret = s_write_instruction(ctx, REG_INTERFACE | REG_FONT_SIZE_5X8 | REG_TWO_LINES | REG_4_BIT_BUS);
+  if (0U == marquee->ahead) {
+    /* Columns left of display window are not shown, they follow right edge.
+       Display as wide as DDRAM line has no such column, leftmost one is rewritten */
+    const uint8_t count = (ctx->column_width < DDRAM_LINE_LEN) ? (uint8_t)(DDRAM_LINE_LEN - ctx->column_width) : 1U;
+    ret = s_marquee_fill(ctx, marquee, (uint8_t)((ctx->state->display_shift + ctx->column_width) % DDRAM_LINE_LEN), count);
     if (HD44780_OK != ret) {
       goto exit;
     }
+    marquee->ahead = count;
+  }
+  ret = s_write_instruction(ctx, REG_DISPLAY_SHIFT | REG_SHIFT_DISPLAY | REG_SHIFT_LEFT);
+  if (HD44780_OK == ret) {
+    marquee->ahead--;
   }
 
-  ret = hd44780_display_off(ctx);
-  if (HD44780_OK != ret) {
+exit:
+  return ret;
+}
+
+void hd44780_bus_invalidate(const hd44780_ctx* const ctx) {
+  ctx->state->bus_direction = BUS_DIR_UNKNOWN;
+}
+
+hd44780_ret_e hd44780_group_init(const hd44780_group* const group) {
+  hd44780_ret_e ret = HD44780_OK;
+  const hd44780_ctx* const bc = group->broadcast;
+
+  if ((0U == group->members_len) || ((NULL != bc) && (!bc->write_only))) {
+    ret = HD44780_INV_ARG;
     goto exit;
   }
-  ret = hd44780_clear(ctx);
-  if (HD44780_OK != ret) {
+
+  if (NULL == bc) {
+    for (uint8_t m = 0U; (HD44780_OK == ret) && (m < group->members_len); m++) {
+      ret = hd44780_init(group->members[m]);
+    }
     goto exit;
   }
-  ret = s_write_instruction(ctx, REG_EM | REG_EM_SHIFT_CURSOR | REG_EM_INCREMENT);
-  if (HD44780_OK != ret) {
-    goto exit;
+
+  ret = hd44780_init(bc);
+  for (uint8_t m = 0U; (HD44780_OK == ret) && (m < group->members_len); m++) {
+    const hd44780_ctx* const ctx = group->members[m];
+    if ((NULL == ctx->state) || s_fb_frames_conflict(ctx)) {
+      ret = HD44780_INV_ARG;
+      break;
+    }
+    /* Every controller went through the same instructions */
+    memcpy(ctx->state, bc->state, sizeof(hd44780_state));
+    hd44780_bus_invalidate(ctx);
+    if (NULL != ctx->framebuffer) {
+      memset(ctx->framebuffer->shadow, FB_BLANK, (size_t)ctx->number_of_lines * ctx->column_width);
+      s_fb_frames_init(ctx);
+      ret = hd44780_fb_clear(ctx);
+      ctx->framebuffer->stale = false;
+    }
   }
-  ret = hd44780_cursor_cfg(ctx, CURSOR_OFF);
-  if (HD44780_OK != ret) {
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_group_flush(const hd44780_group* const group) {
+  hd44780_ret_e ret = HD44780_OK;
+  uint16_t pos[HD44780_GROUP_MAX_MEMBERS] = { 0U };
+  bool done[HD44780_GROUP_MAX_MEMBERS] = { false };
+  uint8_t pending = group->members_len;
+  uint8_t last = UINT8_MAX;
+
+  if (!s_group_valid(group)) {
+    ret = HD44780_INV_ARG;
     goto exit;
   }
-  ret = s_upload_custom_chars(ctx);
+  for (uint8_t m = 0U; m < group->members_len; m++) {
+    s_fb_acquire(group->members[m]->framebuffer);
+  }
+
+  if (NULL != group->broadcast) {
+    ret = s_group_broadcast_cells(group);
+    if (HD44780_OK != ret) {
+      goto exit;
+    }
+  }
+
+  while (0U < pending) {
+    bool progress = false;
+    uint8_t waiting = UINT8_MAX;
+    for (uint8_t m = 0U; m < group->members_len; m++) {
+      const hd44780_ctx* const ctx = group->members[m];
+      if (done[m]) {
+        continue;
+      }
+      if (m != last) {
+        /* Bus is shared, other member might have left it in other direction */
+        hd44780_bus_invalidate(ctx);
+        last = m;
+      }
+      if (hd44780_is_busy(ctx)) {
+        waiting = (UINT8_MAX == waiting) ? m : waiting;
+        continue;
+      }
+      ret = s_flush_step(ctx, &pos[m], &done[m]);
+      if (HD44780_OK != ret) {
+        goto exit;
+      }
+      pending -= done[m] ? 1U : 0U;
+      progress = true;
+    }
+    if ((!progress) && (UINT8_MAX != waiting)) {
+      /* Every member is busy, timeout is detected here */
+      if (waiting != last) {
+        hd44780_bus_invalidate(group->members[waiting]);
+        last = waiting;
+      }
+      ret = s_wait_till_busy(group->members[waiting]);
+      if (HD44780_OK != ret) {
+        goto exit;
+      }
+    }
+  }
 
 exit:
   return ret;
 }
 
-hd44780_ret_e hd44780_display_off(const hd44780_ctx* const ctx) {
-  return s_write_instruction(ctx, REG_PWR_AND_CURSOR | REG_DISPLAY_OFF);
+static void s_fb_frames_init(const hd44780_ctx* const ctx) {
+  hd44780_fb* const fb = ctx->framebuffer;
+
+  if (HAS_FRAMES(fb)) {
+    for (uint8_t f = 0U; f < 3U; f++) {
+      memset(fb->frames[f], FB_BLANK, (size_t)ctx->number_of_lines * ctx->column_width);
+    }
+    fb->swap = FB_SWAP_INIT;
+    fb->cells = fb->frames[FB_SWAP_FRONT(FB_SWAP_INIT)];
+  }
 }
 
-hd44780_ret_e hd44780_def_char(const hd44780_ctx* const ctx, uint8_t index, const uint8_t* const pattern) {
+static uint8_t* s_fb_target(const hd44780_fb* const fb) {
+  /* Only render task moves back frame */
+  return HAS_FRAMES(fb) ? fb->frames[FB_SWAP_BACK(__atomic_load_n(&fb->swap, __ATOMIC_RELAXED))] : fb->cells;
+}
+
+static bool s_fb_frames_conflict(const hd44780_ctx* const ctx) {
+  return (NULL != ctx->framebuffer) && HAS_FRAMES(ctx->framebuffer) && (CGRAM_CHARS < ctx->custom_chars_map_len);
+}
+
+static void s_fb_acquire(hd44780_fb* const fb) {
+  if (!HAS_FRAMES(fb)) {
+    return;
+  }
+
+  uint8_t swap = __atomic_load_n(&fb->swap, __ATOMIC_ACQUIRE);
+  while (0U != (swap & FB_SWAP_FRESH)) {
+    const uint8_t taken = FB_SWAP(FB_SWAP_BACK(swap), FB_SWAP_FRONT(swap), FB_SWAP_READY(swap));
+    if (__atomic_compare_exchange_n(&fb->swap, &swap, taken, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+      fb->cells = fb->frames[FB_SWAP_FRONT(taken)];
+      break;
+    }
+  }
+}
+
+static hd44780_ret_e s_fb_put(const hd44780_ctx* const ctx, uint32_t codepoint) {
+  hd44780_fb* const fb = ctx->framebuffer;
+  uint8_t code = 0U;
+
+  const hd44780_ret_e ret = s_map_codepoint(ctx, codepoint, &code);
+  if ((HD44780_OK == ret) && (fb->column < ctx->column_width)) {
+    s_fb_target(fb)[(fb->row * ctx->column_width) + fb->column] = code;
+    fb->column++;
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_fb_pad(const hd44780_ctx* const ctx, char ch, uint8_t count) {
   hd44780_ret_e ret = HD44780_OK;
-  ret = s_set_char_addr(ctx, index);
-  for (uint8_t i = 0; ((HD44780_OK == ret) && (i < 8)); i++) {
-    ret = s_write_data(ctx, pattern[i]);
+
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < count); i++) {
+    ret = s_fb_put(ctx, (uint8_t)ch);
   }
   return ret;
 }
 
-hd44780_ret_e hd44780_disp_char(const hd44780_ctx* const ctx, uint8_t const index) {
-  return s_write_data(ctx, index);
+static bool s_fmt_field(const char** fmt, uint8_t limit, uint8_t* value) {
+  uint16_t number = 0U;
+
+  /* Saturates above uint8_t range, further digits do not wrap it around */
+  for (; ('0' <= **fmt) && (**fmt <= '9'); (*fmt)++) {
+    number = (uint16_t)((number <= UINT8_MAX) ? ((number * 10U) + (uint16_t)(**fmt - '0')) : number);
+  }
+  *value = (uint8_t)((number < limit) ? number : limit);
+  return (number <= UINT8_MAX);
 }
 
-bool hd44780_is_busy(const hd44780_ctx* const ctx)
-{
-  bool ret = false;
+static hd44780_ret_e s_fb_put_text(const hd44780_ctx* const ctx, const char* text, uint8_t width, uint8_t precision,
+                                   uint8_t flags) {
+  hd44780_ret_e ret = HD44780_OK;
+  const char* const end = text + strlen(text);
+  uint8_t len = 0U;
 
-  if (s_read_address(ctx) & 0x80) {
-    ret = true;
+  /* Padding is counted in characters, not bytes */
+  for (const char* c = text; (c < end) && (len < precision); len++) {
+    (void)s_decode_utf8(&c, end);
   }
+  const uint8_t pad = (len < width) ? (uint8_t)(width - len) : 0U;
 
+  if (0U == (flags & FMT_LEFT)) {
+    ret = s_fb_pad(ctx, ' ', pad);
+  }
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < len); i++) {
+    ret = s_fb_put(ctx, s_decode_utf8(&text, end));
+  }
+  if ((HD44780_OK == ret) && (0U != (flags & FMT_LEFT))) {
+    ret = s_fb_pad(ctx, ' ', pad);
+  }
+  return ret;
+}
+
+static hd44780_ret_e s_fb_put_number(const hd44780_ctx* const ctx, unsigned long magnitude, bool negative,
+                                     uint8_t base, uint8_t width, uint8_t decimals, uint8_t flags) {
+  hd44780_ret_e ret = HD44780_OK;
+  const char* const digits = (0U != (flags & FMT_UPPER)) ? "0123456789ABCDEF" : "0123456789abcdef";
+  char reversed[24U];
+  uint8_t len = 0U;
+
+  decimals = (decimals < FMT_MAX_DECIMALS) ? decimals : FMT_MAX_DECIMALS;
+  /* Fixed-point value has at least one integer digit */
+  do {
+    reversed[len++] = digits[magnitude % base];
+    magnitude /= base;
+  } while ((0UL != magnitude) || (len <= decimals));
+
+  const uint8_t chars = (uint8_t)(len + (negative ? 1U : 0U) + ((0U < decimals) ? 1U : 0U));
+  const uint8_t pad = (chars < width) ? (uint8_t)(width - chars) : 0U;
+  const bool left = (0U != (flags & FMT_LEFT));
+  const bool zero = (0U != (flags & FMT_ZERO)) && (!left);
+
+  if ((!left) && (!zero)) {
+    ret = s_fb_pad(ctx, ' ', pad);
+  }
+  if ((HD44780_OK == ret) && negative) {
+    ret = s_fb_put(ctx, '-');
+  }
+  if ((HD44780_OK == ret) && zero) {
+    ret = s_fb_pad(ctx, '0', pad);
+  }
+  while ((HD44780_OK == ret) && (0U < len)) {
+    if ((0U < decimals) && (len == decimals)) {
+      ret = s_fb_put(ctx, '.');
+    }
+    if (HD44780_OK == ret) {
+      ret = s_fb_put(ctx, (uint8_t)reversed[--len]);
+    }
+  }
+  if ((HD44780_OK == ret) && left) {
+    ret = s_fb_pad(ctx, ' ', pad);
+  }
   return ret;
 }
+
+static hd44780_anim* s_anim_pending(const hd44780_ctx* const ctx) {
+  hd44780_state* const state = ctx->state;
+  const uint32_t now_us = ctx->cb_get_time_us();
+  hd44780_anim* anim = __atomic_load_n(&state->anims, __ATOMIC_ACQUIRE);
+
+  for (; NULL != anim; anim = anim->next) {
+    if ((8U <= anim->row) && ((int32_t)(now_us - anim->due_us) >= 0)) {
+      anim->frame = ((anim->frame + 1U) < anim->frames_len) ? (uint8_t)(anim->frame + 1U) : 0U;
+      anim->row = 0U;
+      /* Late tick does not make following frames shorter, long stall is not caught up */
+      anim->due_us += anim->period_ms * 1000UL;
+      if ((int32_t)(now_us - anim->due_us) >= 0) {
+        anim->due_us = now_us + (anim->period_ms * 1000UL);
+      }
+    }
+
+    const uint8_t* const pattern = anim->frames[anim->frame].character_bitmap;
+    const uint8_t* const cgram = &state->cgram[anim->index * 8U];
+    while ((anim->row < 8U) && (cgram[anim->row] == pattern[anim->row])) {
+      anim->row++;
+    }
+    if (anim->row < 8U) {
+      break;
+    }
+  }
+  return anim;
+}
+
+static uint8_t s_anim_next(const hd44780_ctx* const ctx, bool idle, hd44780_op* const op) {
+  hd44780_state* const state = ctx->state;
+  uint8_t step = ANIM_STEP_NONE;
+  const hd44780_anim* const anim = (idle && (!state->producing)) ? s_anim_pending(ctx) : NULL;
+
+  op->kind = OP_INSTRUCTION;
+  if (NULL != anim) {
+    const uint8_t address = (uint8_t)((anim->index * 8U) + anim->row);
+    if ((0U != state->anim_return) && (address == state->anim_address)) {
+      op->kind = OP_DATA;
+      op->data = anim->frames[anim->frame].character_bitmap[anim->row];
+      step = ANIM_STEP_ROW;
+    } else {
+      op->data = REG_CGRAM_ADDR_SET | address;
+      step = ANIM_STEP_ADDRESS;
+    }
+  } else if (0U != state->anim_return) {
+    op->data = state->anim_return;
+    step = ANIM_STEP_RETURN;
+  }
+  return step;
+}
+
+static void s_anim_commit(const hd44780_ctx* const ctx, uint8_t step, const hd44780_op* const op) {
+  hd44780_state* const state = ctx->state;
+
+  switch (step) {
+    case ANIM_STEP_ADDRESS:
+      if (0U == state->anim_return) {
+        /* Tracked state is up to date with display when queue is empty */
+        const uint8_t address = (ADDR_UNKNOWN == state->address) ? 0U : state->address;
+        state->anim_return = (state->cgram_selected ? REG_CGRAM_ADDR_SET : REG_DDRAM_ADDR_SET) | address;
+      }
+      state->anim_address = op->data & CGRAM_ADDR_MASK;
+      break;
+    case ANIM_STEP_ROW:
+      /* Row matches pattern now, next tick moves past it */
+      state->cgram[state->anim_address] = op->data;
+      state->anim_address = (uint8_t)((0U != (state->entry_mode & REG_EM_INCREMENT)) ?
+                                      (state->anim_address + 1U) : (state->anim_address - 1U)) & CGRAM_ADDR_MASK;
+      break;
+    case ANIM_STEP_RETURN:
+      state->anim_return = 0U;
+      break;
+    default:
+      break;
+  }
+}
+
+#if HD44780_STATS
+static void s_trace(const hd44780_ctx* const ctx, hd44780_trace_kind kind, uint8_t data, uint16_t len) {
+  hd44780_stats* const stats = &ctx->state->stats;
+  switch (kind) {
+    case HD44780_TRACE_INSTRUCTION:
+      stats->instructions++;
+      break;
+    case HD44780_TRACE_DATA:
+    case HD44780_TRACE_DATA_RUN:
+      stats->data_writes += len;
+      break;
+    case HD44780_TRACE_READ_ADDRESS:
+      stats->busy_polls++;
+      break;
+    case HD44780_TRACE_READ_DATA:
+      stats->data_reads++;
+      break;
+    case HD44780_TRACE_BUS_DIRECTION:
+      stats->bus_switches++;
+      break;
+    default:
+      break;
+  }
+
+  if (NULL != ctx->cb_trace) {
+    const hd44780_trace event = {
+      .time_us = (NULL != ctx->cb_get_time_us) ? ctx->cb_get_time_us() : 0U,
+      .kind = kind,
+      .data = data,
+      .len = len,
+    };
+    ctx->cb_trace(ctx, &event);
+  }
+}
+#endif
@@ -5,21 +5,83 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Build time specialisation, optional, has to be defined for whole build.
+ * Checks of context are resolved by compiler and unused paths are dropped:
+ * - HD44780_FIXED_INTERFACE_4BIT or HD44780_FIXED_INTERFACE_8BIT - bus width
+ * - HD44780_FIXED_WRITE_ONLY (0 or 1) - write only mode
+ * - HD44780_NO_ASYNC - asynchronous mode is not used
+ * - HD44780_BSP_WRITE_CYCLE, HD44780_BSP_READ_CYCLE - names of functions 
+ *   called instead of cb_write_cycle and cb_read_cycle, declared (possibly 
+ *   as static inline) in header named by HD44780_BSP_HEADER
+ * - HD44780_STATS (0 or 1) - performance counters in driver state and cb_trace
+ * Driver context still has to be filled consistently, init checks it.
+ */
+
 #ifndef HD44780_TIMEOUT_MS
   /** @brief Timeout on busy flag [ms] */
   #define HD44780_TIMEOUT_MS    (100U)
 #endif
 
+#ifndef HD44780_CMD_RING_LEN
+  /** @brief Number of commands in command ring, has to be power of two */
+  #define HD44780_CMD_RING_LEN    (16U)
+#endif
+#if (0U == HD44780_CMD_RING_LEN) || (0U != (HD44780_CMD_RING_LEN & (HD44780_CMD_RING_LEN - 1U)))
+  #error "HD44780_CMD_RING_LEN has to be power of two"
+#endif
+
+#ifndef HD44780_CMD_TEXT_LEN
+  /** @brief Size of text buffer of single ring command, including terminator [bytes] */
+  #define HD44780_CMD_TEXT_LEN    (32U)
+#endif
+
+#ifndef HD44780_CMD_RING_MPSC
+  /** @brief Command ring producers: 0 - single producer, 1 - multiple producers (CAS) */
+  #define HD44780_CMD_RING_MPSC    (0)
+#endif
+
 #ifndef HD44780_TIMEOUT_TICK_MS
   /** @brief Timeout check tick time [ms] */
   #define HD44780_TIMEOUT_TICK_MS    (1U)
 #endif
 
+#ifndef HD44780_POLL_BACKOFF_MIN_US
+  /** @brief Busy flag poll step around expected execution time, used with microseconds delay callback [us] */
+  #define HD44780_POLL_BACKOFF_MIN_US    (10U)
+#endif
+
+#ifndef HD44780_POLL_BACKOFF_MAX_US
+  /** @brief Busy flag poll backoff limit, backoff doubles with every try past execution time tolerance [us] */
+  #define HD44780_POLL_BACKOFF_MAX_US    (500U)
+#endif
+
+#ifndef HD44780_EXEC_TIME_SCALE_PCT
+  /** @brief Default execution time scale in write only mode, covers oscillator tolerance [%] */
+  #define HD44780_EXEC_TIME_SCALE_PCT    (150U)
+#endif
+
+#ifndef HD44780_REPLACEMENT_CHAR
+  /** @brief Display character code shown in place of invalid UTF-8 sequence */
+  #define HD44780_REPLACEMENT_CHAR    (0x3FU)
+#endif
+
+#ifndef HD44780_GROUP_MAX_MEMBERS
+  /** @brief Maximum number of displays in bus group */
+  #define HD44780_GROUP_MAX_MEMBERS    (8U)
+#endif
+
+#ifndef HD44780_STATS
+  /** @brief Performance counters and bus trace: 0 - not compiled in, 1 - enabled */
+  #define HD44780_STATS    (0)
+#endif
+
 #ifndef DELAY_INIT_SEQ_LONG_MS
   /** @brief Initialisation delay - long period length [ms] */
   #define DELAY_INIT_SEQ_LONG_MS    (50U)
@@ -30,6 +92,16 @@ extern "C" {
   #define DELAY_INIT_SEQ_SHORT_MS    (10U)
 #endif
 
+#ifndef DELAY_INIT_FAST_LONG_US
+  /** @brief Fast initialisation delay - long period length, datasheet minimum [us] */
+  #define DELAY_INIT_FAST_LONG_US    (4100U)
+#endif
+
+#ifndef DELAY_INIT_FAST_SHORT_US
+  /** @brief Fast initialisation delay - short period length, datasheet minimum [us] */
+  #define DELAY_INIT_FAST_SHORT_US    (100U)
+#endif
+
 /** @brief Status codes */
 typedef enum {
   HD44780_OK = 0,                 /**< Success */
@@ -37,6 +109,8 @@ typedef enum {
   HD44780_TIMEOUT = 2,            /**< Timeout */
   HD44780_CUSTOM_CHARS_INV = 3,   /**< Custom character array invalid */
   HD44780_CHAR_NOT_FOUND = 4,     /**< Custom character not found */
+  HD44780_QUEUE_FULL = 5,         /**< Asynchronous operation queue is full */
+  HD44780_CGRAM_FULL = 6,         /**< All CGRAM characters are on screen, glyph cannot be loaded */
 } hd44780_ret_e;
 
 /** @brief Type of interface */
@@ -77,6 +151,171 @@ typedef struct {
   uint8_t character_bitmap[8U];   /**< Mapped character bitmap */
 } character_mapping;
 
+/** @brief Character generator ROM mapping array element */
+typedef struct {
+  uint32_t utf_8_code;   /**< UTF code */
+  uint8_t rom_code;      /**< Display character code of ROM glyph */
+} rom_char_mapping;
+
+/** @brief Length of A00 (Japanese) character ROM translation table */
+#define HD44780_ROM_A00_LEN   (92U)
+/** @brief Length of A02 (European) character ROM translation table */
+#define HD44780_ROM_A02_LEN   (109U)
+
+/** @brief A00 (Japanese) character ROM translation table, to be used as rom_chars_map */
+extern const rom_char_mapping hd44780_rom_a00[HD44780_ROM_A00_LEN];
+/** @brief A02 (European) character ROM translation table, to be used as rom_chars_map */
+extern const rom_char_mapping hd44780_rom_a02[HD44780_ROM_A02_LEN];
+
+/**
+ * @brief Framebuffer - RAM shadow of display characters
+ * 
+ * @details Both arrays have to be number_of_lines * column_width bytes long,
+ *          cell of row r and column c is stored at index r * column_width + c.
+ *          Text is rendered into cells, flush sends only cells that differ
+ *          from shadow, which mirrors what the display has last received.
+ *
+ *          With frames given cells are managed by driver: text is rendered into
+ *          back frame, hd44780_fb_publish() swaps it atomically with frame waiting
+ *          for flush and flush takes the newest published frame. Render task
+ *          and display task do not need a lock and half composed screen is
+ *          never sent. Frames are of the same length as cells. Rendering must
+ *          not use the bus, so frames cannot be combined with glyph cache
+ *          (custom_chars_map longer than 8 characters), init rejects it.
+ */
+typedef struct {
+  uint8_t* cells;      /**< Render target, frame being flushed when frames are given */
+  uint8_t* shadow;     /**< Characters last sent to display */
+  uint8_t row;         /**< Current render row */
+  uint8_t column;      /**< Current render column */
+  bool stale;          /**< Shadow does not match display, next flush sends all cells */
+  uint8_t* frames[3];  /**< Optional frames for tear-free composition, NULL if not used */
+  uint8_t swap;        /**< Roles of frames, private to driver */
+} hd44780_fb;
+
+/** 
+ * @brief Asynchronous operation queue element 
+ * 
+ * @details Application provides array of these, content is private to driver
+ */
+typedef struct {
+  uint8_t kind;       /**< Operation kind */
+  uint8_t data;       /**< Instruction, data byte or notification tag */
+  uint16_t time_us;   /**< Delay time [us] */
+} hd44780_op;
+
+/**
+ * @brief Animated custom character, registered with hd44780_anim_start()
+ * 
+ * @details Every cell showing the character animates, DDRAM is not touched.
+ *          Object is modified by driver.
+ */
+typedef struct hd44780_anim_s {
+  const character_mapping* frames;   /**< Frames, only character_bitmap is used */
+  uint8_t frames_len;                /**< Number of frames */
+  uint8_t index;                     /**< CGRAM character (0 ... 7) */
+  uint16_t period_ms;                /**< Time each frame is shown [ms] */
+  uint8_t frame;                     /**< Frame being shown, private to driver */
+  uint8_t row;                       /**< Next pattern row to be compared, private to driver */
+  uint32_t due_us;                   /**< Time of next frame [us], private to driver */
+  struct hd44780_anim_s* next;       /**< Next registered animation, private to driver */
+} hd44780_anim;
+
+/** @brief Kind of traced bus transaction */
+typedef enum {
+  HD44780_TRACE_INSTRUCTION,     /**< Instruction register write, init sequence nibbles included */
+  HD44780_TRACE_DATA,            /**< Data register write */
+  HD44780_TRACE_DATA_RUN,        /**< Run of data register writes passed to cb_write_data_run */
+  HD44780_TRACE_READ_ADDRESS,    /**< Busy flag and address counter read */
+  HD44780_TRACE_READ_DATA,       /**< Data register read */
+  HD44780_TRACE_BUS_DIRECTION    /**< Bus direction switch */
+} hd44780_trace_kind;
+
+/** @brief Bus transaction passed to cb_trace */
+typedef struct {
+  uint32_t time_us;          /**< Time of transaction end from cb_get_time_us [us], 0 if not available */
+  hd44780_trace_kind kind;   /**< Transaction kind */
+  uint8_t data;              /**< Byte written or read, first byte of run, new direction (hd44780_gpio_dir) */
+  uint16_t len;              /**< Number of bytes, more than 1 for data run only */
+} hd44780_trace;
+
+/**
+ * @brief Performance counters, HD44780_STATS build only
+ * 
+ * @details Counted since init, application may read them or zero them any time.
+ *          Writes are counted when they reach the bus, in asynchronous mode by hd44780_tick()
+ */
+typedef struct {
+  uint32_t instructions;    /**< Instruction register writes, init sequence nibbles included */
+  uint32_t data_writes;     /**< Data register bytes written, CGRAM included */
+  uint32_t data_reads;      /**< Data register bytes read */
+  uint32_t busy_polls;      /**< Busy flag and address counter reads */
+  uint32_t bus_switches;    /**< Bus direction switches */
+  uint32_t busy_wait_us;    /**< Time spent waiting for busy flag (needs cb_get_time_us) or execution time [us] */
+  uint32_t diff_saved;      /**< Data bytes not sent because framebuffer cell or CGRAM row did not change */
+  uint16_t timeouts;        /**< Busy flag timeouts */
+  uint16_t cgram_uploads;   /**< CGRAM characters defined or changed (custom map, glyph cache, def_char) */
+} hd44780_stats;
+
+/**
+ * @brief Driver runtime state
+ * 
+ * @details Memory is provided by application, content is maintained by driver
+ *          and should not be modified, it lets the driver context stay constant
+ */
+typedef struct {
+  uint8_t address;         /**< Address counter, 0xFF when unknown */
+  uint8_t bus_direction;   /**< Current bus direction (hd44780_gpio_dir), 0xFF when unknown */
+  bool cgram_selected;     /**< Address counter points to CGRAM instead of DDRAM */
+  uint8_t entry_mode;      /**< Last entry mode set instruction */
+  uint8_t display_ctrl;    /**< Last display on/off control instruction */
+  uint8_t display_shift;   /**< DDRAM column shown in leftmost display column */
+  uint8_t cgram_loaded;    /**< Bit mask of CGRAM characters defined since init */
+  uint8_t cgram_visible;   /**< Bit mask of CGRAM characters written to DDRAM since last clear */
+  uint16_t cgram_glyph[8U];  /**< Glyph cache, custom_chars_map index held by CGRAM character, 0xFFFF if none */
+  uint8_t cgram_lru[8U];   /**< Glyph cache, CGRAM characters from most to least recently used */
+  uint16_t exec_time_us;   /**< Write only mode, execution time of last write not waited yet [us] */
+  uint32_t exec_start_us;  /**< Time of last write [us] */
+  uint16_t poll_expect_us; /**< Busy flag mode with cb_delay_us, expected execution time of last write [us] */
+  bool paced;              /**< Transport paces writes (framebuffer flush batch), execution times are not waited */
+  volatile uint16_t queue_head;   /**< Asynchronous mode, next free queue element */
+  volatile uint16_t queue_tail;   /**< Asynchronous mode, oldest queue element */
+  uint8_t cgram[64U];      /**< CGRAM contents */
+  uint16_t recoveries;     /**< Number of hd44780_recover() calls since init, can be read by application */
+  hd44780_anim* anims;     /**< Asynchronous mode, registered animations */
+  volatile bool producing; /**< Asynchronous mode, operation is being queued and tracked */
+  uint8_t anim_return;     /**< Asynchronous mode, address set instruction restoring address moved by animation, 0 if none */
+  uint8_t anim_address;    /**< Asynchronous mode, CGRAM address of animation write */
+  uint8_t scrub_row;       /**< Part of display verified by next hd44780_scrub() */
+  uint16_t scrub_repairs;  /**< Number of cells and CGRAM characters rewritten by hd44780_scrub(), can be read by application */
+#if HD44780_STATS
+  hd44780_stats stats;     /**< Performance counters, can be read by application */
+#endif
+} hd44780_state;
+
+/** @brief Command ring element, content is private to driver */
+typedef struct {
+  uint32_t seq;                         /**< Slot sequence number */
+  uint8_t kind;                         /**< Command kind */
+  uint8_t row;                          /**< Row number */
+  uint8_t column;                       /**< Column number */
+  uint8_t arg;                          /**< Command argument */
+  char text[HD44780_CMD_TEXT_LEN];      /**< Null terminated text */
+} hd44780_cmd;
+
+/**
+ * @brief Lock-free ring of display commands
+ * 
+ * @details Producers (e.g. RTOS tasks) post commands, single consumer (display task)
+ *          executes them with hd44780_cmd_process(), so display is never accessed 
+ *          concurrently and no mutex is needed
+ */
+typedef struct {
+  hd44780_cmd slots[HD44780_CMD_RING_LEN];   /**< Commands */
+  uint32_t head;                             /**< Next position to be reserved by producer */
+  uint32_t tail;                             /**< Next position to be executed by consumer */
+} hd44780_cmd_ring;
+
 /* Forward declaration of struct */
 struct hd44780_ctx_s;
 
@@ -95,6 +334,8 @@ typedef struct hd44780_ctx_s {
    * @details callback responsibility:
    *          - configure LCD bus (pins D4 ... D7 or D0 ... D7) 
    *            as GPIO, push-pull outputs or high Z inputs
+   * 
+   * @note In write only mode it might be NULL
    */
   void (*cb_set_bus_direction)(hd44780_gpio_dir);
   /**
@@ -102,6 +343,9 @@ typedef struct hd44780_ctx_s {
    * 
    * @details callback responsibility:
    *          - change output state of control pin (E, RS or RW)
+   * 
+   * @note Might be NULL if cb_write_cycle and cb_read_cycle are provided
+   *       and interrupt driven busy flag wait is not used
    */
   void (*cb_set_ctrl_pin_state)(hd44780_ctrl_pin, hd44780_pin_state);
   /**
@@ -111,6 +355,8 @@ typedef struct hd44780_ctx_s {
    *          - read state of bus GPIO pins
    *          - in case of 4 bit bus, shift D4 ... D7 bits 
    *            onto 4 ... 7 bits of return octet, bits 0 ... 3 are ignored
+   * 
+   * @note In write only mode or if cb_read_cycle is provided it might be NULL
    */
   uint8_t (*cb_read_bus)(void);
   /**
@@ -119,18 +365,109 @@ typedef struct hd44780_ctx_s {
    * @details callback responsibility:
    *          - set state of GPIO output pins of display bus
    *          - in case of 4 bit bus, bits 0 ... 3 are ignored
+   * 
+   * @note Might be NULL if cb_write_cycle is provided
    */
   void (*cb_write_bus)(uint8_t);
+  /**
+   * @brief Optional callback performing whole write cycle, preferred over per pin callbacks
+   * 
+   * @details callback responsibility:
+   *          - set RS pin to rs state and RW pin low
+   *          - put data on the bus and strobe E pin
+   *          - if nibble_mode is true (4-bit bus, whole byte) repeat 
+   *            with bits 0 ... 3 of data put on D4 ... D7, 
+   *            otherwise in case of 4 bit bus bits 0 ... 3 are ignored
+   *          Bus direction is still configured with cb_set_bus_direction
+   * 
+   * @param[in] ctx driver context
+   * @param[in] rs RS pin state (instruction or data register)
+   * @param[in] data data to be written
+   * @param[in] nibble_mode whole byte has to be sent as two nibbles
+   */
+  void (*cb_write_cycle)(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+  /**
+   * @brief Optional callback performing whole read cycle, preferred over per pin callbacks
+   * 
+   * @details callback responsibility:
+   *          - set RS pin to rs state and RW pin high
+   *          - strobe E pin and read the bus while E is high
+   *          - if nibble_mode is true (4-bit bus) repeat and put second 
+   *            D4 ... D7 read onto bits 0 ... 3 of return octet
+   * 
+   * @param[in] ctx driver context
+   * @param[in] rs RS pin state (instruction or data register)
+   * @param[in] nibble_mode whole byte has to be read as two nibbles
+   * 
+   * @return byte read
+   */
+  uint8_t (*cb_read_cycle)(const struct hd44780_ctx_s* const ctx, hd44780_pin_state rs, bool nibble_mode);
+  /**
+   * @brief Optional callback writing run of data register bytes in one transfer
+   * 
+   * @details Used for text runs and framebuffer flush instead of one cb_write_cycle
+   *          per byte, e.g. to pack whole string into single I2C expander transfer.
+   *          Busy flag is not checked between bytes, so callback responsibility is:
+   *          - set RS pin high and RW pin low
+   *          - write each byte as cb_write_cycle does, keeping consecutive bytes 
+   *            at least 37us (scaled by exec_time_scale_pct) apart on the bus
+   *          Not used in asynchronous mode
+   * 
+   * @param[in] ctx driver context
+   * @param[in] data bytes to be written
+   * @param[in] len number of bytes
+   * @param[in] nibble_mode every byte has to be sent as two nibbles
+   */
+  void (*cb_write_data_run)(const struct hd44780_ctx_s* const ctx, const uint8_t* data, size_t len, bool nibble_mode);
+  /**
+   * @brief Optional callback called before framebuffer flush writes, write only mode
+   * 
+   * @details Lets transport collect the whole flush and send it at once (e.g. with DMA),
+   *          until cb_flush_end the driver does not wait execution times, so 
+   *          transport has to keep every write at least 37us (scaled by
+   *          exec_time_scale_pct) apart on the bus. Not used in asynchronous mode
+   * 
+   * @param[in] ctx driver context
+   */
+  void (*cb_flush_begin)(const struct hd44780_ctx_s* const ctx);
+  /**
+   * @brief Optional callback called after framebuffer flush writes, required with cb_flush_begin
+   * 
+   * @details Transport sends collected writes, it might return before transfer is done
+   *          as long as following writes wait for it
+   * 
+   * @param[in] ctx driver context
+   */
+  void (*cb_flush_end)(const struct hd44780_ctx_s* const ctx);
   /**
    * @brief Callback used for miliseconds delay during LCD initialisation
    * 
    * @param[in] time_ms time [ms]
    */
   void (*cb_delay_ms)(uint8_t time_ms);
+  /**
+   * @brief Optional callback used for microseconds delay, NULL if not available
+   * 
+   * @param[in] time_us time [us]
+   */
+  void (*cb_delay_us)(uint16_t time_us);
+  /**
+   * @brief Optional callback used to get monotonic time, NULL if not available
+   * 
+   * @details callback responsibility:
+   *          - return free running microseconds counter, 
+   *            it is allowed to wrap around from 0xFFFFFFFF to 0
+   * 
+   * @return time [us]
+   */
+  uint32_t (*cb_get_time_us)(void);
 
   /**
    * @brief Callback used to wait for busy flag clear
    * 
+   * @details NULL can be passed to use hd44780_wait_while_busy(),
+   *          in write only mode callback is not used
+   * 
    * @param[in] ctx driver context
    * 
    * @return status
@@ -139,14 +476,101 @@ typedef struct hd44780_ctx_s {
    * @retval HD44780_TIMEOUT   Timeout
    */
   hd44780_ret_e (*cb_wait_for_busy_flag_clear)(const struct hd44780_ctx_s* const ctx);
+  /**
+   * @brief Optional callback arming busy flag clear interrupt
+   * 
+   * @details Used by hd44780_wait_while_busy() together with cb_busy_wait_signalled,
+   *          it is called while read cycle is held with E pin high, so pin D7 
+   *          reflects busy flag. Callback responsibility:
+   *          - discard signal left from previous wait, if any
+   *          - enable interrupt on D7 falling edge, which signals waiting thread
+   * 
+   * @param[in] ctx driver context
+   */
+  void (*cb_busy_wait_begin)(const struct hd44780_ctx_s* const ctx);
+  /**
+   * @brief Optional callback putting calling thread to sleep until busy flag clear is signalled
+   * 
+   * @details Callback responsibility:
+   *          - block (e.g. on semaphore) until interrupt armed by cb_busy_wait_begin
+   *            fires or timeout elapses
+   * 
+   * @param[in] ctx driver context
+   * @param[in] timeout_ms timeout [ms]
+   * 
+   * @return true if interrupt fired, false on timeout
+   */
+  bool (*cb_busy_wait_signalled)(const struct hd44780_ctx_s* const ctx, uint32_t timeout_ms);
+  /**
+   * @brief Optional callback called from hd44780_tick() when queued notification is reached
+   * 
+   * @param[in] ctx driver context
+   * @param[in] tag notification tag passed to hd44780_async_notify()
+   */
+  void (*cb_async_done)(const struct hd44780_ctx_s* const ctx, uint8_t tag);
+#if HD44780_STATS
+  /**
+   * @brief Optional callback called after each bus transaction, HD44780_STATS build only
+   * 
+   * @details Called from the context of the transaction (hd44780_tick() in asynchronous mode),
+   *          so it should only record the event, e.g. into RAM ring or ITM port
+   * 
+   * @param[in] ctx driver context
+   * @param[in] event bus transaction
+   */
+  void (*cb_trace)(const struct hd44780_ctx_s* const ctx, const hd44780_trace* const event);
+#endif
   /** 
    * @brief Custom character map pointer 
    */
   const character_mapping* custom_chars_map;
   /** 
    * @brief Custom character map length 
+   * 
+   * @details Up to 8 characters are uploaded once during init. Longer maps
+   *          are served by glyph cache: characters are loaded to CGRAM on
+   *          demand, least recently used one which is not on screen is evicted.
+   *          With framebuffer, cells and shadow tell which are on screen,
+   *          otherwise every character written since last clear counts.
+   */
+  uint16_t custom_chars_map_len;
+  /** 
+   * @brief Custom character map is sorted by ascending utf_8_code, binary search is used
+   */
+  bool custom_chars_map_sorted;
+  /** 
+   * @brief Character generator ROM map pointer, NULL if not used
+   * 
+   * @details Has to be sorted by ascending utf_8_code. Codepoints found here 
+   *          are displayed with built-in glyphs, custom_chars_map is searched 
+   *          only if codepoint is missing. Tables of display ROM types are
+   *          provided: hd44780_rom_a00 and hd44780_rom_a02
    */
-  uint8_t custom_chars_map_len;
+  const rom_char_mapping* rom_chars_map;
+  /** 
+   * @brief Character generator ROM map length 
+   */
+  uint16_t rom_chars_map_len;
+  /** 
+   * @brief Runtime state, required
+   */
+  hd44780_state* state;
+  /** 
+   * @brief Framebuffer, NULL if characters are written directly to display
+   */
+  hd44780_fb* framebuffer;
+  /**
+   * @brief Asynchronous operation queue, NULL for blocking operation
+   * 
+   * @details When queue is provided public functions only put bus operations
+   *          into it and return, operations are executed by hd44780_tick(),
+   *          one per call. cb_get_time_us is required in this mode.
+   */
+  hd44780_op* queue;
+  /**
+   * @brief Asynchronous operation queue length (one element is always kept free)
+   */
+  uint16_t queue_len;
   /**
    * @brief Number of lines (1, 2 or 4)
    */
@@ -159,8 +583,85 @@ typedef struct hd44780_ctx_s {
    * @brief Interface bus width 
    */
   hd44780_interface interface;
+  /**
+   * @brief Write only mode (RW pin tied to ground)
+   * 
+   * @details Display is never read, instead of busy flag poll the driver waits
+   *          datasheet execution time of each instruction (37us, 1.52ms for clear
+   *          and return home) multiplied by exec_time_scale_pct. RW pin is not
+   *          driven. Microseconds callbacks are recommended, otherwise delays are
+   *          rounded up to milliseconds.
+   */
+  bool write_only;
+  /**
+   * @brief Write only mode execution time scale [%], 0 for HD44780_EXEC_TIME_SCALE_PCT
+   * 
+   * @details Datasheet execution times are specified for 270kHz oscillator,
+   *          slow oscillator of particular display can be covered here.
+   *          With busy flag and cb_delay_us it scales time waited before first
+   *          poll, 0 stands for datasheet time there
+   */
+  uint16_t exec_time_scale_pct;
+  /**
+   * @brief Smart clear, overwrite non blank cells instead of Clear Display when cheaper
+   * 
+   * @details Requires framebuffer in sync with display. Clear Display takes 1.52ms,
+   *          when shadow buffer holds only few non blank cells the driver
+   *          writes spaces over them and sets address 0 instead
+   */
+  bool smart_clear;
+  /**
+   * @brief Fast initialisation, datasheet minimum delays of reset sequence
+   * 
+   * @details DELAY_INIT_FAST_LONG_US and DELAY_INIT_FAST_SHORT_US are used instead
+   *          of DELAY_INIT_SEQ_LONG_MS and DELAY_INIT_SEQ_SHORT_MS, microseconds
+   *          callbacks are recommended, otherwise delays are rounded up to milliseconds
+   */
+  bool fast_init;
+  /**
+   * @brief Warm initialisation, skip reset sequence if controller is already set up
+   * 
+   * @details Init checks busy flag, sets DDRAM address and reads it back. If it
+   *          matches, controller already works with configured bus width (e.g. after
+   *          MCU reset) and reset sequence is skipped. Otherwise full initialisation
+   *          follows. Not available in write only mode
+   */
+  bool warm_init;
+  /**
+   * @brief Application data, not used by driver
+   * 
+   * @details Lets callbacks taking ctx reach data of their display instance,
+   *          e.g. port expander transport (hd44780_pcf8574)
+   */
+  void* user_data;
 } hd44780_ctx;
 
+/**
+ * @brief Text scrolled along display row with display shift
+ * 
+ * @details Object is given by application, fields marked private are maintained by driver
+ */
+typedef struct {
+  const char* text;        /**< Null terminated UTF-8 text, repeated in loop */
+  uint8_t row;             /**< Row (0 or 1) */
+  const char* next;        /**< Next character to be streamed, private to driver */
+  uint8_t ahead;           /**< Filled DDRAM columns right of display window, private to driver */
+} hd44780_marquee;
+
+/**
+ * @brief Displays sharing data, RS and RW lines, each with its own E line
+ * 
+ * @details Every member is a regular context (own E pin callbacks, state and
+ *          framebuffer) of the same geometry. Broadcast context, if wired, has
+ *          the same configuration except that it strobes E lines of all members
+ *          at once, it has to be write only and has its own state
+ */
+typedef struct {
+  const hd44780_ctx* const* members;   /**< Member contexts */
+  uint8_t members_len;                 /**< Number of members, up to HD44780_GROUP_MAX_MEMBERS */
+  const hd44780_ctx* broadcast;        /**< Context strobing all E lines, NULL if not used */
+} hd44780_group;
+
 /**
  * @brief Initialise HD44780 LCD
  * 
@@ -168,16 +669,31 @@ typedef struct hd44780_ctx_s {
  * 
  * @note Delay 15ms after power on have to be done prior to calling this function
  * 
+ * @note In asynchronous mode initialisation is only queued, time consuming 
+ *       delays are waited in hd44780_tick()
+ * 
  * @return status
  * @retval HD44780_OK               Success
+ * @retval HD44780_INV_ARG          No runtime state in context, no cb_get_time_us
+ *                                  in asynchronous mode or framebuffer frames
+ *                                  given together with glyph cache
  * @retval HD44780_TIMEOUT          Timeout
  * @retval HD44780_CUSTOM_CHARS_INV Custom characters array is invalid (too big)
  */
 hd44780_ret_e hd44780_init(const hd44780_ctx* const ctx);
 
+/*
+ * In asynchronous mode (queue provided in context) functions below return
+ * HD44780_QUEUE_FULL if operations did not fit into the queue, in such case
+ * part of them might be already queued.
+ */
+
 /**
  * @brief Clears whole display
  * 
+ * @details With smart_clear enabled cheaper of Clear Display instruction
+ *          and overwriting non blank cells with spaces is chosen
+ * 
  * @param[in] ctx driver context
  * 
  * @return status
@@ -196,15 +712,49 @@ hd44780_ret_e hd44780_clear(const hd44780_ctx* const ctx);
  *       for example in case of some displays it might jump two lines below, since
  *       this is how HD44780 map memory is organised
  *       - UTF-8 characters are supported. Characters are searched from 
- *       ctx->custom_chars_map map and displayed
+ *       ctx->rom_chars_map and ctx->custom_chars_map maps and displayed
+ *       - Invalid UTF-8 sequences are displayed as HD44780_REPLACEMENT_CHAR
  * 
  * @return status
  * @retval HD44780_OK                Success
  * @retval HD44780_TIMEOUT           Timeout
  * @retval HD44780_CHAR_NOT_FOUND    Character not found in custom chars array
+ * @retval HD44780_CGRAM_FULL        No CGRAM character can be evicted for glyph
  */
 hd44780_ret_e hd44780_write_text(const hd44780_ctx* const ctx, const char* text);
 
+/**
+ * @brief Write UTF-8 buffer of given length on LCD, starting from current position
+ * 
+ * @param[in] ctx driver context
+ * @param[in] buf UTF-8 text, does not have to be null terminated
+ * @param[in] len buffer length in bytes
+ * 
+ * @note Same as hd44780_write_text(), runs of ASCII characters are sent 
+ *       without decoding. Invalid UTF-8 sequences, also those cut by end of 
+ *       buffer, are displayed as HD44780_REPLACEMENT_CHAR
+ * 
+ * @return status
+ * @retval HD44780_OK                Success
+ * @retval HD44780_TIMEOUT           Timeout
+ * @retval HD44780_CHAR_NOT_FOUND    Character not found in custom chars array
+ * @retval HD44780_CGRAM_FULL        No CGRAM character can be evicted for glyph
+ */
+hd44780_ret_e hd44780_write_buf(const hd44780_ctx* const ctx, const char* buf, size_t len);
+
+/**
+ * @brief Write display character codes on LCD, starting from current position
+ * 
+ * @param[in] ctx driver context
+ * @param[in] buf character codes, sent without any translation
+ * @param[in] len buffer length in bytes
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_write_raw(const hd44780_ctx* const ctx, const uint8_t* buf, size_t len);
+
 /**
  * @brief Set cursor at desired position
  * 
@@ -222,6 +772,8 @@ hd44780_ret_e hd44780_set_pos(const hd44780_ctx* const ctx, uint8_t row, uint8_t
 /**
  * @brief Configure cursor type
  * 
+ * @note Display on/off state is not changed
+ * 
  * @param[in] ctx driver context
  * @param[in] cursor_cfg cursor configuration
  * 
@@ -235,7 +787,8 @@ hd44780_ret_e hd44780_cursor_cfg(const hd44780_ctx* const ctx, hd44780_cursor cu
 /**
  * @brief Turn display off
  * 
- * @note To turn the display on again use init function
+ * @note Display and CGRAM contents and cursor configuration are retained,
+ *       to turn the display on again use hd44780_display_on()
  * 
  * @param[in] ctx driver context
  *
@@ -245,6 +798,71 @@ hd44780_ret_e hd44780_cursor_cfg(const hd44780_ctx* const ctx, hd44780_cursor cu
  */
 hd44780_ret_e hd44780_display_off(const hd44780_ctx* const ctx);
 
+/**
+ * @brief Turn display on, restoring last cursor configuration
+ * 
+ * @param[in] ctx driver context
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_display_on(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Shift whole display content, one instruction per column
+ * 
+ * @details Every row moves, DDRAM line of 40 characters wraps around.
+ *          Address counter is not moved, positions set with hd44780_set_pos()
+ *          address DDRAM, which is shown shifted: leftmost display column
+ *          shows DDRAM column state->display_shift. Clear and init bring
+ *          display back to not shifted state
+ * 
+ * @param[in] ctx driver context
+ * @param[in] columns number of columns, positive moves content left
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_scroll(const hd44780_ctx* const ctx, int8_t columns);
+
+/**
+ * @brief Start marquee, display is brought back to not shifted state
+ * 
+ * @details DDRAM line of the row is filled with beginning of text. Only 1 and 2
+ *          line displays are supported, since rows of 4 line display share DDRAM lines
+ * 
+ * @note Display shift moves every row, content of other row scrolls as well
+ * 
+ * @param[in] ctx driver context
+ * @param[in] marquee marquee, text and row have to be set
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Invalid row, empty text or 4 line display
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_marquee_start(const hd44780_ctx* const ctx, hd44780_marquee* const marquee);
+
+/**
+ * @brief Scroll marquee by one column
+ * 
+ * @details One display shift instruction, when DDRAM right of display window
+ *          runs out, following characters are streamed into columns which
+ *          are not shown first
+ * 
+ * @note Display address is moved, call hd44780_set_pos() before writing text
+ * 
+ * @param[in] ctx driver context
+ * @param[in] marquee marquee started with hd44780_marquee_start()
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_marquee_step(const hd44780_ctx* const ctx, hd44780_marquee* const marquee);
+
 /**
  * @brief Define custom character
  * 
@@ -252,12 +870,35 @@ hd44780_ret_e hd44780_display_off(const hd44780_ctx* const ctx);
  * @param[in] index index of character in memory (starts with 0)
  * @param[in] pattern pointer to 8 byte character patern array
  * 
+ * @note Display address is restored afterwards, so text can be written
+ *       further without setting position again
+ * @note With more than 8 characters in custom_chars_map, glyph cache
+ *       might reuse this character once it is not on screen
+ * 
  * @return status
  * @retval HD44780_OK      Success
  * @retval HD44780_TIMEOUT Timeout
  */
 hd44780_ret_e hd44780_def_char(const hd44780_ctx* const ctx, uint8_t index, const uint8_t* const pattern);
 
+/**
+ * @brief Define custom character, only pattern rows that differ from CGRAM are written
+ * 
+ * @details Character that has not been defined since init is written whole,
+ *          same pattern costs no bus access at all
+ * 
+ * @param[in] ctx driver context
+ * @param[in] index index of character in memory (starts with 0)
+ * @param[in] pattern pointer to 8 byte character patern array
+ * 
+ * @note Same notes as for hd44780_def_char() apply
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_def_char_diff(const hd44780_ctx* const ctx, uint8_t index, const uint8_t* const pattern);
+
 /**
  * @brief Show custom character
  * 
@@ -270,11 +911,67 @@ hd44780_ret_e hd44780_def_char(const hd44780_ctx* const ctx, uint8_t index, cons
  */
 hd44780_ret_e hd44780_disp_char(const hd44780_ctx* const ctx, uint8_t index);
 
+/**
+ * @brief Read DDRAM bytes, one address set followed by reads with auto increment
+ * 
+ * @param[in] ctx driver context, bus has to be readable and no queue used
+ * @param[in] address DDRAM address of first byte (0x40 is start of second line)
+ * @param[out] buf bytes read
+ * @param[in] len number of bytes
+ * 
+ * @note Display address is restored afterwards
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Write only or asynchronous mode
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_read_ddram(const hd44780_ctx* const ctx, uint8_t address, uint8_t* buf, size_t len);
+
+/**
+ * @brief Read CGRAM bytes, one address set followed by reads with auto increment
+ * 
+ * @param[in] ctx driver context, bus has to be readable and no queue used
+ * @param[in] address CGRAM address of first byte (character index * 8 + pattern row)
+ * @param[out] buf bytes read, only 5 lower bits are meaningful
+ * @param[in] len number of bytes
+ * 
+ * @note Display address is restored afterwards
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Write only or asynchronous mode
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_read_cgram(const hd44780_ctx* const ctx, uint8_t address, uint8_t* buf, size_t len);
+
+/**
+ * @brief Resynchronise bus and restore display after fault
+ * 
+ * @details Intended to be called after HD44780_TIMEOUT (ESD hit, loose connector)
+ *          instead of hd44780_init(). Reset sequence is sent with execution time
+ *          delays only, which brings controller back into nibble phase, then
+ *          entry mode, display shift (return home and shift instructions), CGRAM
+ *          contents, framebuffer cells, address and display control are restored
+ *          from driver state. Without framebuffer DDRAM
+ *          contents are not restored. state->recoveries is incremented.
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_TIMEOUT    Timeout, controller did not respond
+ * @retval HD44780_QUEUE_FULL Queue is full
+ */
+hd44780_ret_e hd44780_recover(const hd44780_ctx* const ctx);
+
 /**
  * @brief Check if display is bussy
  * 
  * @details This function is intended to be used only in one of callback functions
- *          to make it easy to implement efficient wait mechanism 
+ *          to make it easy to implement efficient wait mechanism.
+ *          In write only mode display is not read, result is based on 
+ *          execution time of last write 
  *
  * @param[in] ctx context 
  * 
@@ -283,6 +980,358 @@ hd44780_ret_e hd44780_disp_char(const hd44780_ctx* const ctx, uint8_t index);
  */
 bool hd44780_is_busy(const hd44780_ctx* const ctx);
 
+/**
+ * @brief Wait until display is not busy
+ * 
+ * @details Default wait mechanism, busy flag is polled until it is cleared
+ *          or HD44780_TIMEOUT_MS elapses. With cb_delay_us available the first
+ *          poll waits until expected execution time of last write has passed
+ *          (time since the write is subtracted when cb_get_time_us is available).
+ *          Polls are then HD44780_POLL_BACKOFF_MIN_US apart until slow oscillator
+ *          time (HD44780_EXEC_TIME_SCALE_PCT) has passed too, after that backoff
+ *          doubles up to HD44780_POLL_BACKOFF_MAX_US. Without cb_delay_us busy flag
+ *          is polled back to back with cb_get_time_us, otherwise HD44780_TIMEOUT_TICK_MS 
+ *          delays are used. With cb_get_time_us available timeout is measured
+ *          against deadline instead of summing up delays.
+ *          When cb_busy_wait_begin and cb_busy_wait_signalled are provided,
+ *          calling thread sleeps until busy flag clear interrupt instead.
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ * @retval HD44780_OK        Success
+ * @retval HD44780_TIMEOUT   Timeout
+ */
+hd44780_ret_e hd44780_wait_while_busy(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Execute next queued operation in asynchronous mode
+ * 
+ * @details Intended to be called periodically, e.g. from timer interrupt.
+ *          Nothing is done if display is still busy, otherwise one bus
+ *          transaction is executed, so time spent here is bounded.
+ *          Public functions of the same context should not be called from
+ *          higher priority context than this one.
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ * @retval HD44780_OK      Success, operation executed or nothing to do yet
+ * @retval HD44780_TIMEOUT Busy flag was not cleared in time, queue is dropped
+ */
+hd44780_ret_e hd44780_tick(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Queue notification, cb_async_done is called when it is reached
+ * 
+ * @param[in] ctx driver context
+ * @param[in] tag notification tag passed to callback
+ * 
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_INV_ARG    Not in asynchronous mode
+ * @retval HD44780_QUEUE_FULL Queue is full
+ */
+hd44780_ret_e hd44780_async_notify(const hd44780_ctx* const ctx, uint8_t tag);
+
+/**
+ * @brief Check if all queued operations are executed
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return true    queue is empty
+ * @return false   there are operations waiting
+ */
+bool hd44780_async_idle(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Register animated custom character, serviced by hd44780_tick()
+ * 
+ * @details While queue is empty, each tick sends one instruction or pattern row
+ *          of due frame, only rows that differ from CGRAM are written. Display
+ *          address is restored before next queued operation.
+ * 
+ * @note hd44780_tick() must not be preempted by code calling other driver
+ *       functions, e.g. it is called from timer interrupt
+ * 
+ * @param[in] ctx driver context, asynchronous mode
+ * @param[in,out] anim animation, first frame is shown right away
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG No queue, invalid character index or no frames
+ */
+hd44780_ret_e hd44780_anim_start(const hd44780_ctx* const ctx, hd44780_anim* const anim);
+
+/**
+ * @brief Unregister animated custom character, character keeps pattern of last frame
+ * 
+ * @details Stopped while frame is being written, character keeps rows written so
+ *          far. Address moved by animation is still restored by hd44780_tick()
+ * 
+ * @param[in] ctx driver context
+ * @param[in] anim animation registered with hd44780_anim_start()
+ */
+void hd44780_anim_stop(const hd44780_ctx* const ctx, hd44780_anim* const anim);
+
+/**
+ * @brief Initialise command ring
+ * 
+ * @param[in] ring command ring
+ */
+void hd44780_cmd_ring_init(hd44780_cmd_ring* const ring);
+
+/**
+ * @brief Post text command, text will be written starting at given position
+ * 
+ * @details Text longer than HD44780_CMD_TEXT_LEN - 1 bytes is truncated 
+ *          on UTF-8 character boundary
+ * 
+ * @param[in] ring command ring
+ * @param[in] row row number (0 is at the top)
+ * @param[in] column column number (0 is the leftmost)
+ * @param[in] text null terminated string
+ * 
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_QUEUE_FULL Ring is full
+ */
+hd44780_ret_e hd44780_cmd_post_text(hd44780_cmd_ring* const ring, uint8_t row, uint8_t column, const char* text);
+
+/**
+ * @brief Post clear command
+ * 
+ * @param[in] ring command ring
+ * 
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_QUEUE_FULL Ring is full
+ */
+hd44780_ret_e hd44780_cmd_post_clear(hd44780_cmd_ring* const ring);
+
+/**
+ * @brief Post cursor command, cursor is configured and placed at given position
+ * 
+ * @param[in] ring command ring
+ * @param[in] row row number (0 is at the top)
+ * @param[in] column column number (0 is the leftmost)
+ * @param[in] cursor_cfg cursor configuration
+ * 
+ * @return status
+ * @retval HD44780_OK         Success
+ * @retval HD44780_QUEUE_FULL Ring is full
+ */
+hd44780_ret_e hd44780_cmd_post_cursor(hd44780_cmd_ring* const ring, uint8_t row, uint8_t column, hd44780_cursor cursor_cfg);
+
+/**
+ * @brief Execute all commands posted to ring
+ * 
+ * @details With framebuffer commands are rendered into it and flushed at the end,
+ *          otherwise they are written directly to display. Only one context
+ *          (display task) can call this function for given ring.
+ * 
+ * @param[in] ctx driver context
+ * @param[in] ring command ring
+ * 
+ * @return status of first failed command or HD44780_OK
+ */
+hd44780_ret_e hd44780_cmd_process(const hd44780_ctx* const ctx, hd44780_cmd_ring* const ring);
+
+/**
+ * @brief Set framebuffer render position
+ * 
+ * @param[in] ctx driver context
+ * @param[in] row row number (0 is at the top)
+ * @param[in] column column number (0 is the leftmost)
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Invalid position choosed or no framebuffer
+ */
+hd44780_ret_e hd44780_fb_set_pos(const hd44780_ctx* const ctx, uint8_t row, uint8_t column);
+
+/**
+ * @brief Render string into framebuffer, starting from current render position
+ * 
+ * @param[in] ctx driver context
+ * @param[in] text null terminated string to be rendered
+ * 
+ * @note Unlike hd44780_write_text() text does not jump to another line,
+ *       characters that does not fit in the row are dropped
+ * 
+ * @return status
+ * @retval HD44780_OK                Success
+ * @retval HD44780_INV_ARG           No framebuffer
+ * @retval HD44780_CHAR_NOT_FOUND    Character not found in custom chars array
+ */
+hd44780_ret_e hd44780_fb_write_text(const hd44780_ctx* const ctx, const char* text);
+
+/**
+ * @brief Render formatted text into framebuffer at given position
+ * 
+ * @details Small formatter writing straight into framebuffer cells, no heap and
+ *          no intermediate string buffer. Conversions: %[-0][width][.precision][l]
+ *          d i u x X s c and %%. Precision of d i u is number of fraction digits
+ *          of fixed-point value ("%5.1d" of 215 renders " 21.5"), precision of s
+ *          is maximum number of characters, NULL string renders "(null)". Width
+ *          is counted in characters. Width and precision are saturated at row
+ *          width, numbers above 255 are rejected.
+ * 
+ * @param[in] ctx driver context
+ * @param[in] row row number (0 is at the top)
+ * @param[in] column column number (0 is the leftmost)
+ * @param[in] fmt null terminated UTF-8 format string
+ * 
+ * @note Like hd44780_fb_write_text() characters that does not fit in the row are dropped
+ * 
+ * @return status
+ * @retval HD44780_OK                Success
+ * @retval HD44780_INV_ARG           Invalid position, no framebuffer, unknown conversion or
+ *                                   width or precision above 255
+ * @retval HD44780_CHAR_NOT_FOUND    Character not found in custom chars array
+ */
+hd44780_ret_e hd44780_printf_at(const hd44780_ctx* const ctx, uint8_t row, uint8_t column, const char* fmt, ...);
+
+/**
+ * @brief Render display character codes into framebuffer, starting from current render position
+ * 
+ * @param[in] ctx driver context
+ * @param[in] buf character codes, stored without any translation
+ * @param[in] len buffer length in bytes
+ * 
+ * @note Codes that does not fit in the row are dropped
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG No framebuffer
+ */
+hd44780_ret_e hd44780_fb_write_raw(const hd44780_ctx* const ctx, const uint8_t* buf, size_t len);
+
+/**
+ * @brief Fill framebuffer with spaces and move render position to the origin
+ * 
+ * @note Display is not touched until hd44780_flush() is called
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG No framebuffer
+ */
+hd44780_ret_e hd44780_fb_clear(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Publish composed back frame, next flush sends it
+ * 
+ * @details Back frame is swapped atomically with frame waiting for flush and
+ *          new back frame starts as a copy of published one. Frame published
+ *          earlier and not flushed yet is dropped. Only one context (render task)
+ *          can render and publish for given framebuffer.
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG No framebuffer or no frames
+ */
+hd44780_ret_e hd44780_fb_publish(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Forget what display shows, next flush will send every cell
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG No framebuffer
+ */
+hd44780_ret_e hd44780_fb_invalidate(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Send framebuffer cells that differ from what display shows
+ * 
+ * @details Changed cells are grouped into runs written with DDRAM address
+ *          auto increment, address is set only when run does not continue
+ *          where the previous one ended. Runs are passed to cb_write_data_run
+ *          and whole flush is enclosed by cb_flush_begin and cb_flush_end, when
+ *          provided
+ * 
+ * @note Flush moves display address, call hd44780_set_pos() before 
+ *       writing text directly to display
+ * 
+ * @param[in] ctx driver context
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG No framebuffer
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_flush(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Verify one part of display against driver state, rewrite cells that differ
+ * 
+ * @details Each call reads back one row of DDRAM and compares it with
+ *          framebuffer shadow, every (number_of_lines + 1)-th call verifies
+ *          CGRAM characters defined since init. Mismatches (e.g. after EMI) are
+ *          rewritten with what display should show and counted in
+ *          scrub_repairs of driver state. Meant to be called periodically
+ *          from low priority context. Nothing is done while framebuffer is stale.
+ * 
+ * @param[in] ctx driver context, bus has to be readable and no queue used
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG No framebuffer, write only or asynchronous mode
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_scrub(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Forget bus direction, bus is shared and other display might have used it
+ * 
+ * @details Next access configures bus direction (and RW pin) again
+ * 
+ * @param[in] ctx driver context
+ */
+void hd44780_bus_invalidate(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Initialise all displays of bus group
+ * 
+ * @details With broadcast context all displays are initialised at once,
+ *          member states are set up without bus traffic. Otherwise members
+ *          are initialised one after another
+ * 
+ * @param[in] group bus group
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Invalid group or context
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_group_init(const hd44780_group* const group);
+
+/**
+ * @brief Flush framebuffers of all displays of bus group, interleaved
+ * 
+ * @details Cells equal on every member are written once with broadcast
+ *          context, if provided. Remaining cells are written one byte at a time
+ *          to whichever member is not busy, so one display executes while
+ *          another one receives. Asynchronous mode is not supported
+ * 
+ * @note Display addresses are moved, call hd44780_set_pos() before 
+ *       writing text directly to display
+ * 
+ * @param[in] group bus group
+ * 
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Invalid group, context without framebuffer or with queue
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_group_flush(const hd44780_group* const group);
+
 #ifdef __cplusplus
 }
 #endif
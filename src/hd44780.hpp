@@ -0,0 +1,188 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#ifndef __HD44780__HPP__
+#define __HD44780__HPP__
+
+/*
+ * Header only C++17 front end. UTF-8 string literals are translated into
+ * display character codes at compile time, at runtime precomputed codes are
+ * streamed with hd44780_write_raw(), no heap is used.
+ *
+ *   constexpr char32_t lcd_cgram[] = { U'è', U'↑' };
+ *   constexpr hd44780::font lcd_font(hd44780::rom_a00, lcd_cgram);
+ *   constexpr auto greeting = lcd_font.encode("Très bien ↑ 21°C");
+ *   static_assert(greeting.valid(), "unmapped character");
+ *   hd44780::write(lcd_ctx, greeting);
+ */
+
+#include "hd44780.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hd44780 {
+
+/** @brief A00 (Japanese) character ROM translation table, same as hd44780_rom_a00 */
+inline constexpr rom_char_mapping rom_a00[] = {
+#include "hd44780_rom_a00.inc"
+};
+
+/** @brief A02 (European) character ROM translation table, same as hd44780_rom_a02 */
+inline constexpr rom_char_mapping rom_a02[] = {
+#include "hd44780_rom_a02.inc"
+};
+
+static_assert(sizeof(rom_a00) / sizeof(rom_a00[0]) == HD44780_ROM_A00_LEN, "A00 table length mismatch");
+static_assert(sizeof(rom_a02) / sizeof(rom_a02[0]) == HD44780_ROM_A02_LEN, "A02 table length mismatch");
+
+/**
+ * @brief Display character codes of encoded string
+ *
+ * @tparam N capacity, string literal size is enough since every
+ *           character takes at least one byte
+ */
+template <std::size_t N>
+struct text {
+  uint8_t codes[N] = {};     /**< Display character codes */
+  std::size_t len = 0U;      /**< Number of codes */
+  std::size_t unmapped = 0U; /**< Unmapped characters and malformed sequences, replaced with HD44780_REPLACEMENT_CHAR */
+
+  /** @brief Check whether every character has been mapped */
+  constexpr bool valid() const { return 0U == unmapped; }
+  /** @brief Display character codes */
+  constexpr const uint8_t* data() const { return codes; }
+  /** @brief Number of display character codes */
+  constexpr std::size_t size() const { return len; }
+};
+
+/**
+ * @brief Character set of display - ROM translation table and fixed CGRAM assignment
+ *
+ * @details Codepoint found in ROM table is displayed with built-in glyph,
+ *          otherwise its index in cgram array is used as CGRAM character code,
+ *          the same way C core does for custom_chars_map of up to 8 characters.
+ *          So cgram array has to follow custom_chars_map order and glyph cache
+ *          (map longer than 8 characters) must not be used.
+ *
+ * @tparam R number of ROM table elements
+ * @tparam C number of CGRAM characters, up to 8
+ */
+template <std::size_t R, std::size_t C>
+class font {
+  static_assert(C <= 8U, "HD44780 CGRAM holds 8 characters");
+
+ public:
+  constexpr font(const rom_char_mapping (&rom)[R], const char32_t (&cgram)[C]) : rom_(rom), cgram_(cgram) {}
+
+  /**
+   * @brief Translate UTF-8 string into display character codes
+   *
+   * @param[in] str UTF-8 string literal
+   *
+   * @return encoded string, check valid() with static_assert
+   */
+  template <std::size_t N>
+  constexpr text<N> encode(const char (&str)[N]) const {
+    text<N> out{};
+    std::size_t i = 0U;
+    /* Literal terminator is not encoded */
+    const std::size_t end = ((0U < N) && ('\0' == str[N - 1U])) ? (N - 1U) : N;
+
+    while (i < end) {
+      const char32_t codepoint = decode(str, end, i);
+      uint8_t code = HD44780_REPLACEMENT_CHAR;
+      if (!map(codepoint, code)) {
+        out.unmapped++;
+      }
+      out.codes[out.len++] = code;
+    }
+    return out;
+  }
+
+ private:
+  static constexpr char32_t invalid = 0xFFFFFFFFU;
+
+  /* Same rules as C core decoder: overlong, surrogates and cut sequences are invalid */
+  static constexpr char32_t decode(const char* str, std::size_t end, std::size_t& i) {
+    const uint8_t lead = static_cast<uint8_t>(str[i++]);
+    const uint8_t len = (lead < 0x80U) ? 1U : (lead < 0xC0U) ? 0U : (lead < 0xE0U) ? 2U :
+                        (lead < 0xF0U) ? 3U : (lead < 0xF8U) ? 4U : 0U;
+    constexpr uint8_t lead_mask[5] = { 0x00U, 0x7FU, 0x1FU, 0x0FU, 0x07U };
+    constexpr char32_t min[5] = { 0U, 0U, 0x80U, 0x800U, 0x10000U };
+    char32_t codepoint = lead & lead_mask[len];
+    uint8_t n = 1U;
+
+    while ((n < len) && (i < end) && (0x80U == (static_cast<uint8_t>(str[i]) & 0xC0U))) {
+      codepoint = (codepoint << 6U) | (static_cast<uint8_t>(str[i++]) & 0x3FU);
+      n++;
+    }
+    if ((0U == len) || (n < len) || (codepoint < min[len]) || (0x10FFFFU < codepoint) ||
+        ((0xD800U <= codepoint) && (codepoint <= 0xDFFFU))) {
+      codepoint = invalid;
+    }
+    return codepoint;
+  }
+
+  constexpr bool map(char32_t codepoint, uint8_t& code) const {
+    if (codepoint <= 0x7FU) {
+      code = static_cast<uint8_t>(codepoint);
+      return true;
+    }
+    if (invalid == codepoint) {
+      /* Malformed sequence keeps replacement character and is counted as unmapped */
+      return false;
+    }
+    for (std::size_t i = 0U; i < R; i++) {
+      if (rom_[i].utf_8_code == codepoint) {
+        code = rom_[i].rom_code;
+        return true;
+      }
+    }
+    for (std::size_t i = 0U; i < C; i++) {
+      if (cgram_[i] == codepoint) {
+        code = static_cast<uint8_t>(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const rom_char_mapping (&rom_)[R];
+  const char32_t (&cgram_)[C];
+};
+
+/**
+ * @brief Stream precomputed display character codes, starting from current position
+ *
+ * @param[in] ctx driver context
+ * @param[in] str encoded string
+ *
+ * @return status of hd44780_write_raw()
+ */
+template <std::size_t N>
+inline hd44780_ret_e write(const hd44780_ctx* const ctx, const text<N>& str) {
+  return hd44780_write_raw(ctx, str.data(), str.size());
+}
+
+/**
+ * @brief Stream precomputed display character codes at given position
+ *
+ * @param[in] ctx driver context
+ * @param[in] row row number (0 is at the top)
+ * @param[in] column column number (0 is the leftmost)
+ * @param[in] str encoded string
+ *
+ * @return status of hd44780_set_pos() or hd44780_write_raw()
+ */
+template <std::size_t N>
+inline hd44780_ret_e write_at(const hd44780_ctx* const ctx, uint8_t row, uint8_t column, const text<N>& str) {
+  hd44780_ret_e ret = hd44780_set_pos(ctx, row, column);
+  if (HD44780_OK == ret) {
+    ret = hd44780_write_raw(ctx, str.data(), str.size());
+  }
+  return ret;
+}
+
+} // namespace hd44780
+
+#endif /* __HD44780__HPP__ */
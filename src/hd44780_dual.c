@@ -0,0 +1,121 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#include "hd44780_dual.h"
+
+#include <stdint.h>
+
+/* Static, "private" functions declarations */
+
+/**
+ * @brief Bus group of both controllers
+ *
+ * @param[in] dual dual controller display
+ *
+ * @return bus group
+ */
+static hd44780_group s_group(const hd44780_dual* const dual);
+
+/**
+ * @brief Get controller for bus access, bus direction is forgotten when other one used it
+ *
+ * @param[in] dual dual controller display
+ * @param[in] half controller index
+ *
+ * @return controller context
+ */
+static const hd44780_ctx* s_take_bus(hd44780_dual* const dual, uint8_t half);
+
+/* Static functions implementation */
+
+static hd44780_group s_group(const hd44780_dual* const dual) {
+  const hd44780_group group = {
+    .members = dual->half,
+    .members_len = 2U,
+    .broadcast = dual->broadcast,
+  };
+  return group;
+}
+
+static const hd44780_ctx* s_take_bus(hd44780_dual* const dual, uint8_t half) {
+  if (half != dual->bus_owner) {
+    hd44780_bus_invalidate(dual->half[half]);
+    dual->bus_owner = half;
+  }
+  return dual->half[half];
+}
+
+/* "Public" functions implementation */
+
+hd44780_ret_e hd44780_dual_init(hd44780_dual* const dual) {
+  const hd44780_group group = s_group(dual);
+  dual->active = 0U;
+  dual->fb_active = 0U;
+  dual->bus_owner = UINT8_MAX;
+  return hd44780_group_init(&group);
+}
+
+hd44780_ret_e hd44780_dual_clear(hd44780_dual* const dual) {
+  /* Second clear is sent while first controller still executes */
+  hd44780_ret_e ret = hd44780_clear(s_take_bus(dual, 0U));
+  if (HD44780_OK == ret) {
+    ret = hd44780_clear(s_take_bus(dual, 1U));
+  }
+  return ret;
+}
+
+hd44780_ret_e hd44780_dual_set_pos(hd44780_dual* const dual, uint8_t row, uint8_t column) {
+  hd44780_ret_e ret = HD44780_INV_ARG;
+  if (row < (2U * HD44780_DUAL_HALF_ROWS)) {
+    const uint8_t half = row / HD44780_DUAL_HALF_ROWS;
+    ret = hd44780_set_pos(s_take_bus(dual, half), row % HD44780_DUAL_HALF_ROWS, column);
+    if (HD44780_OK == ret) {
+      dual->active = half;
+    }
+  }
+  return ret;
+}
+
+hd44780_ret_e hd44780_dual_write_text(hd44780_dual* const dual, const char* text) {
+  return hd44780_write_text(s_take_bus(dual, dual->active), text);
+}
+
+hd44780_ret_e hd44780_dual_cursor_cfg(hd44780_dual* const dual, hd44780_cursor cursor_cfg) {
+  const uint8_t active = dual->active;
+  hd44780_ret_e ret = hd44780_cursor_cfg(s_take_bus(dual, active), cursor_cfg);
+  if (HD44780_OK == ret) {
+    ret = hd44780_cursor_cfg(s_take_bus(dual, active ^ 1U), CURSOR_OFF);
+  }
+  return ret;
+}
+
+hd44780_ret_e hd44780_dual_fb_set_pos(hd44780_dual* const dual, uint8_t row, uint8_t column) {
+  hd44780_ret_e ret = HD44780_INV_ARG;
+  if (row < (2U * HD44780_DUAL_HALF_ROWS)) {
+    const uint8_t half = row / HD44780_DUAL_HALF_ROWS;
+    ret = hd44780_fb_set_pos(dual->half[half], row % HD44780_DUAL_HALF_ROWS, column);
+    if (HD44780_OK == ret) {
+      dual->fb_active = half;
+    }
+  }
+  return ret;
+}
+
+hd44780_ret_e hd44780_dual_fb_write_text(hd44780_dual* const dual, const char* text) {
+  return hd44780_fb_write_text(dual->half[dual->fb_active], text);
+}
+
+hd44780_ret_e hd44780_dual_fb_clear(hd44780_dual* const dual) {
+  hd44780_ret_e ret = hd44780_fb_clear(dual->half[0]);
+  if (HD44780_OK == ret) {
+    ret = hd44780_fb_clear(dual->half[1]);
+  }
+  dual->fb_active = 0U;
+  return ret;
+}
+
+hd44780_ret_e hd44780_dual_flush(hd44780_dual* const dual) {
+  const hd44780_group group = s_group(dual);
+  /* Group flush switches between controllers on its own */
+  dual->bus_owner = UINT8_MAX;
+  return hd44780_group_flush(&group);
+}
@@ -0,0 +1,148 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#ifndef __HD44780_DUAL__H__
+#define __HD44780_DUAL__H__
+
+#include "hd44780.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dual controller display (e.g. 40x4 module). Both controllers share data, RS and
+ * RW lines, each one has its own E line and drives two rows. Rows 0 ... 3 are routed
+ * to the right controller, framebuffer flush is interleaved with hd44780_group_flush(),
+ * so both controllers execute at the same time.
+ *
+ * Both halves are regular contexts of 2 lines with their own state. Framebuffer of
+ * 4 rows is shared, framebuffer of the lower half points to its rows 2 and 3:
+ *
+ *   static uint8_t cells[4 * 40];
+ *   static uint8_t shadow[4 * 40];
+ *   static hd44780_fb fb_upper = { .cells = cells, .shadow = shadow };
+ *   static hd44780_fb fb_lower = { .cells = &cells[2 * 40], .shadow = &shadow[2 * 40] };
+ *   static hd44780_dual lcd = { .half = { &lcd_e1_ctx, &lcd_e2_ctx } };
+ */
+
+/** @brief Rows driven by one controller */
+#define HD44780_DUAL_HALF_ROWS (2U)
+
+/**
+ * @brief Dual controller display
+ *
+ * @details Object is modified by driver, it remembers controller selected by
+ *          last hd44780_dual_set_pos() and hd44780_dual_fb_set_pos()
+ */
+typedef struct {
+  const hd44780_ctx* half[2];     /**< Controllers of rows 0, 1 (E1) and rows 2, 3 (E2) */
+  const hd44780_ctx* broadcast;   /**< Context strobing both E lines, write only, NULL if not used */
+  uint8_t active;                 /**< Controller selected for direct writes, private to driver */
+  uint8_t fb_active;              /**< Controller selected for framebuffer writes, private to driver */
+  uint8_t bus_owner;              /**< Controller which used bus last, private to driver */
+} hd44780_dual;
+
+/**
+ * @brief Initialise both controllers
+ *
+ * @param[in] dual dual controller display
+ *
+ * @return status of hd44780_group_init()
+ */
+hd44780_ret_e hd44780_dual_init(hd44780_dual* const dual);
+
+/**
+ * @brief Clear display, both controllers execute clear at the same time
+ *
+ * @param[in] dual dual controller display
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_dual_clear(hd44780_dual* const dual);
+
+/**
+ * @brief Set display position and select controller for following writes
+ *
+ * @param[in] dual dual controller display
+ * @param[in] row row number (0 ... 3)
+ * @param[in] column column number (0 is the leftmost)
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Invalid position
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_dual_set_pos(hd44780_dual* const dual, uint8_t row, uint8_t column);
+
+/**
+ * @brief Write UTF-8 text with controller selected by hd44780_dual_set_pos()
+ *
+ * @param[in] dual dual controller display
+ * @param[in] text null terminated UTF-8 text
+ *
+ * @return status of hd44780_write_text()
+ */
+hd44780_ret_e hd44780_dual_write_text(hd44780_dual* const dual, const char* text);
+
+/**
+ * @brief Configure cursor, shown by selected controller only
+ *
+ * @param[in] dual dual controller display
+ * @param[in] cursor_cfg cursor type
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Invalid cursor type
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_dual_cursor_cfg(hd44780_dual* const dual, hd44780_cursor cursor_cfg);
+
+/**
+ * @brief Set framebuffer render position
+ *
+ * @param[in] dual dual controller display
+ * @param[in] row row number (0 ... 3)
+ * @param[in] column column number (0 is the leftmost)
+ *
+ * @return status of hd44780_fb_set_pos()
+ */
+hd44780_ret_e hd44780_dual_fb_set_pos(hd44780_dual* const dual, uint8_t row, uint8_t column);
+
+/**
+ * @brief Render UTF-8 text into framebuffer, clipped at the end of the row
+ *
+ * @param[in] dual dual controller display
+ * @param[in] text null terminated UTF-8 text
+ *
+ * @return status of hd44780_fb_write_text()
+ */
+hd44780_ret_e hd44780_dual_fb_write_text(hd44780_dual* const dual, const char* text);
+
+/**
+ * @brief Fill framebuffer with spaces and move render position to the origin
+ *
+ * @param[in] dual dual controller display
+ *
+ * @return status of hd44780_fb_clear()
+ */
+hd44780_ret_e hd44780_dual_fb_clear(hd44780_dual* const dual);
+
+/**
+ * @brief Send changed framebuffer cells, both controllers interleaved
+ *
+ * @param[in] dual dual controller display
+ *
+ * @return status of hd44780_group_flush()
+ */
+hd44780_ret_e hd44780_dual_flush(hd44780_dual* const dual);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HD44780_DUAL__H__ */
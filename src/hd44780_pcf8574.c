@@ -0,0 +1,105 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#include "hd44780_pcf8574.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Static, "private" functions declarations */
+
+/**
+ * @brief Port state of control pins, E excluded
+ *
+ * @param[in] pcf transport
+ * @param[in] rs RS pin state
+ *
+ * @return port bits
+ */
+static uint8_t s_ctrl_bits(const hd44780_pcf8574* const pcf, hd44780_pin_state rs);
+
+/**
+ * @brief Pack one nibble strobe into buffer
+ *
+ * @param[in] pcf transport
+ * @param[out] out buffer, 2 bytes are written
+ * @param[in] ctrl control pins port bits
+ * @param[in] nibble nibble on bits 4 ... 7
+ *
+ * @return number of bytes packed
+ */
+static size_t s_pack_nibble(const hd44780_pcf8574* const pcf, uint8_t* const out, uint8_t ctrl, uint8_t nibble);
+
+/**
+ * @brief Pack display byte into buffer
+ *
+ * @param[in] pcf transport
+ * @param[out] out buffer, up to HD44780_PCF8574_BYTES_PER_CHAR bytes are written
+ * @param[in] ctrl control pins port bits
+ * @param[in] data display byte
+ * @param[in] nibble_mode whole byte has to be sent as two nibbles
+ *
+ * @return number of bytes packed
+ */
+static size_t s_pack_byte(const hd44780_pcf8574* const pcf, uint8_t* const out, uint8_t ctrl, uint8_t data, bool nibble_mode);
+
+/* Static functions implementation */
+
+static uint8_t s_ctrl_bits(const hd44780_pcf8574* const pcf, hd44780_pin_state rs) {
+  uint8_t ctrl = pcf->backlight ? pcf->pin_backlight : 0U;
+  if (PIN_SET == rs) {
+    ctrl |= pcf->pin_rs;
+  }
+  return ctrl;
+}
+
+static size_t s_pack_nibble(const hd44780_pcf8574* const pcf, uint8_t* const out, uint8_t ctrl, uint8_t nibble) {
+  /* Data is latched on falling edge of E */
+  const uint8_t port = ctrl | (uint8_t)(((nibble >> 4U) & 0x0FU) << pcf->data_shift);
+  out[0] = port | pcf->pin_e;
+  out[1] = port;
+  return 2U;
+}
+
+static size_t s_pack_byte(const hd44780_pcf8574* const pcf, uint8_t* const out, uint8_t ctrl, uint8_t data, bool nibble_mode) {
+  size_t len = s_pack_nibble(pcf, out, ctrl, data);
+  if (nibble_mode) {
+    len += s_pack_nibble(pcf, &out[len], ctrl, (uint8_t)(data << 4U));
+  }
+  return len;
+}
+
+/* "Public" functions implementation */
+
+void hd44780_pcf8574_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode) {
+  const hd44780_pcf8574* const pcf = (const hd44780_pcf8574*)ctx->user_data;
+  const size_t len = s_pack_byte(pcf, pcf->buf, s_ctrl_bits(pcf, rs), data, nibble_mode);
+  pcf->cb_i2c_write(pcf->address, pcf->buf, len);
+}
+
+void hd44780_pcf8574_write_data_run(const hd44780_ctx* const ctx, const uint8_t* data, size_t len, bool nibble_mode) {
+  const hd44780_pcf8574* const pcf = (const hd44780_pcf8574*)ctx->user_data;
+  const uint8_t ctrl = s_ctrl_bits(pcf, PIN_SET);
+  size_t used = 0U;
+
+  for (size_t i = 0U; i < len; i++) {
+    if ((pcf->buf_len - used) < (HD44780_PCF8574_BYTES_PER_CHAR + pcf->pad_bytes)) {
+      pcf->cb_i2c_write(pcf->address, pcf->buf, used);
+      used = 0U;
+    }
+    used += s_pack_byte(pcf, &pcf->buf[used], ctrl, data[i], nibble_mode);
+    /* E stays low, port keeps last nibble */
+    memset(&pcf->buf[used], pcf->buf[used - 1U], pcf->pad_bytes);
+    used += pcf->pad_bytes;
+  }
+  if (0U < used) {
+    pcf->cb_i2c_write(pcf->address, pcf->buf, used);
+  }
+}
+
+void hd44780_pcf8574_set_backlight(const hd44780_ctx* const ctx, bool on) {
+  hd44780_pcf8574* const pcf = (hd44780_pcf8574*)ctx->user_data;
+  pcf->backlight = on;
+  /* E stays low, display does not see this write */
+  pcf->buf[0] = s_ctrl_bits(pcf, PIN_RESET);
+  pcf->cb_i2c_write(pcf->address, pcf->buf, 1U);
+}
@@ -0,0 +1,146 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#ifndef __HD44780_PCF8574__H__
+#define __HD44780_PCF8574__H__
+
+#include "hd44780.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * PCF8574 (and alike) I2C backpack transport. Every port write is one byte of
+ * I2C transfer, RS, E, backlight and D4 ... D7 of whole display byte (both nibbles,
+ * E high and low) are packed into transfer buffer and sent with single I2C write.
+ * Runs of characters are packed into one transfer as long as buffer allows.
+ *
+ * Display is driven in 4 bit write only mode, RW pin has to be kept low:
+ *
+ *   static uint8_t lcd_i2c_buf[64];
+ *   static hd44780_pcf8574 lcd_pcf = HD44780_PCF8574_DEFAULT(0x27, lcd_i2c_buf,
+ *     HD44780_PCF8574_PAD_BYTES(400000U, HD44780_EXEC_TIME_SCALE_PCT), lcd_i2c_write);
+ *   static const hd44780_ctx lcd_ctx = {
+ *     .cb_write_cycle = hd44780_pcf8574_write_cycle,
+ *     .cb_write_data_run = hd44780_pcf8574_write_data_run,
+ *     .interface = INTERFACE_4BIT,
+ *     .write_only = true,
+ *     .user_data = &lcd_pcf,
+ *     ...
+ *   };
+ */
+
+/** @brief Port expander bytes per display byte without pad bytes - E high and low for each nibble */
+#define HD44780_PCF8574_BYTES_PER_CHAR (4U)
+
+/**
+ * @brief Pad bytes keeping characters of data run 37us scaled by scale_pct apart
+ *
+ * @details Controller executes character from E falling edge of its second nibble
+ *          (last byte) to E falling edge of first nibble of the next one, which comes
+ *          2 bytes later. Byte is 9 I2C clocks, e.g. 1 at 400kHz and 150%, 0 up to 324kHz
+ *
+ * @param i2c_hz I2C clock [Hz]
+ * @param scale_pct execution time scale, HD44780_EXEC_TIME_SCALE_PCT or exec_time_scale_pct [%]
+ */
+#define HD44780_PCF8574_PAD_BYTES(i2c_hz, scale_pct)                 \
+  ((uint8_t)((HD44780_PCF8574_GAP_BYTES(i2c_hz, scale_pct) > 2U) ?  \
+             (HD44780_PCF8574_GAP_BYTES(i2c_hz, scale_pct) - 2U) : 0U))
+
+/** @brief Bytes between E falling edges of consecutive characters required by HD44780_PCF8574_PAD_BYTES(), rounded up */
+#define HD44780_PCF8574_GAP_BYTES(i2c_hz, scale_pct) \
+  (((37ULL * (scale_pct) * (i2c_hz)) + 899999999ULL) / 900000000ULL)
+
+/**
+ * @brief Port expander transport, pointed by user_data of driver context
+ *
+ * @details Pins are given as port bit masks, D4 ... D7 have to be
+ *          consecutive port bits starting from data_shift
+ */
+typedef struct {
+  uint8_t address;           /**< 7 bit I2C address */
+  uint8_t pin_rs;            /**< RS pin mask */
+  uint8_t pin_e;             /**< E pin mask */
+  uint8_t pin_backlight;     /**< Backlight pin mask, 0 if not connected */
+  uint8_t data_shift;        /**< Port bit of D4 */
+  bool backlight;            /**< Backlight on */
+  /**
+   * @brief Bytes with E low appended to each character of data run
+   *
+   * @details E falling edges of consecutive characters have to be at least 37us
+   *          (scaled by exec_time_scale_pct) apart: (2 + pad_bytes) * 9 I2C clocks,
+   *          HD44780_PCF8574_PAD_BYTES() computes it
+   */
+  uint8_t pad_bytes;
+  uint8_t* buf;              /**< Transfer buffer, e.g. DMA capable memory */
+  size_t buf_len;            /**< Transfer buffer length, at least HD44780_PCF8574_BYTES_PER_CHAR + pad_bytes */
+  /**
+   * @brief Callback writing bytes to I2C device
+   *
+   * @details Has to return once transfer is complete, since driver measures
+   *          execution times from then and buffer is reused. Transfer might be
+   *          done with DMA, while calling thread waits
+   *
+   * @param[in] address 7 bit I2C address
+   * @param[in] data bytes to be written
+   * @param[in] len number of bytes
+   */
+  void (*cb_i2c_write)(uint8_t address, const uint8_t* data, size_t len);
+} hd44780_pcf8574;
+
+/**
+ * @brief Common backpack wiring: P0 RS, P1 RW, P2 E, P3 backlight, P4 ... P7 D4 ... D7
+ *
+ * @param addr 7 bit I2C address (0x20 ... 0x27 for PCF8574, 0x38 ... 0x3F for PCF8574A)
+ * @param buffer transfer buffer array
+ * @param pad number of pad bytes
+ * @param i2c_write I2C write callback
+ */
+#define HD44780_PCF8574_DEFAULT(addr, buffer, pad, i2c_write)                             \
+  {                                                                                       \
+    .address = (addr), .pin_rs = 0x01U, .pin_e = 0x04U, .pin_backlight = 0x08U,           \
+    .data_shift = 4U, .backlight = true, .pad_bytes = (pad), .buf = (buffer),             \
+    .buf_len = sizeof(buffer), .cb_i2c_write = (i2c_write),                               \
+  }
+
+/**
+ * @brief Write cycle of driver context (cb_write_cycle), one I2C transfer
+ *
+ * @param[in] ctx driver context, user_data points hd44780_pcf8574
+ * @param[in] rs RS pin state (instruction or data register)
+ * @param[in] data data to be written
+ * @param[in] nibble_mode whole byte has to be sent as two nibbles
+ */
+void hd44780_pcf8574_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+
+/**
+ * @brief Data run write of driver context (cb_write_data_run)
+ *
+ * @details Characters are packed into buffer, one I2C transfer per full buffer.
+ *          Each character takes HD44780_PCF8574_BYTES_PER_CHAR + pad_bytes bytes
+ *          on the bus, pad bytes keep execution time of character at given I2C clock
+ *
+ * @param[in] ctx driver context, user_data points hd44780_pcf8574
+ * @param[in] data bytes to be written
+ * @param[in] len number of bytes
+ * @param[in] nibble_mode every byte has to be sent as two nibbles
+ */
+void hd44780_pcf8574_write_data_run(const hd44780_ctx* const ctx, const uint8_t* data, size_t len, bool nibble_mode);
+
+/**
+ * @brief Turn backlight on or off
+ *
+ * @param[in] ctx driver context, user_data points hd44780_pcf8574
+ * @param[in] on backlight state
+ */
+void hd44780_pcf8574_set_backlight(const hd44780_ctx* const ctx, bool on);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HD44780_PCF8574__H__ */
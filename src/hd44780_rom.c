@@ -0,0 +1,16 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#include "hd44780.h"
+
+/* 
+ * Character generator ROM translation tables, based on HD44780U datasheet 
+ * character code tables. Sorted by ascending codepoint as rom_chars_map requires. 
+ */
+
+const rom_char_mapping hd44780_rom_a00[HD44780_ROM_A00_LEN] = {
+#include "hd44780_rom_a00.inc"
+};
+
+const rom_char_mapping hd44780_rom_a02[HD44780_ROM_A02_LEN] = {
+#include "hd44780_rom_a02.inc"
+};
@@ -0,0 +1,157 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#include "hd44780_sr595.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Static, "private" functions declarations */
+
+/**
+ * @brief Transfer completion, passed to cb_transfer_async
+ *
+ * @param[in] sr transport
+ */
+static void s_transfer_done(hd44780_sr595* const sr);
+
+/**
+ * @brief Wait until transfer in progress is done
+ *
+ * @param[in] sr transport
+ */
+static void s_wait_pending(hd44780_sr595* const sr);
+
+/**
+ * @brief Start transfer of collected frames
+ *
+ * @param[in] sr transport
+ * @param[in] wait wait for completion
+ */
+static void s_send(hd44780_sr595* const sr, bool wait);
+
+/**
+ * @brief Output state of control pins, E excluded
+ *
+ * @param[in] sr transport
+ * @param[in] rs RS pin state
+ *
+ * @return output bits
+ */
+static uint8_t s_ctrl_bits(const hd44780_sr595* const sr, hd44780_pin_state rs);
+
+/**
+ * @brief Collect frames of display byte, buffer is sent first if it has no room
+ *
+ * @param[in] sr transport
+ * @param[in] ctrl control pins output bits
+ * @param[in] data display byte
+ * @param[in] nibble_mode whole byte has to be sent as two nibbles
+ */
+static void s_put_byte(hd44780_sr595* const sr, uint8_t ctrl, uint8_t data, bool nibble_mode);
+
+/* Static functions implementation */
+
+static void s_transfer_done(hd44780_sr595* const sr) {
+  sr->pending = false;
+}
+
+static void s_wait_pending(hd44780_sr595* const sr) {
+  while (sr->pending) {
+    if (NULL != sr->cb_wait_idle) {
+      sr->cb_wait_idle();
+    }
+  }
+}
+
+static void s_send(hd44780_sr595* const sr, bool wait) {
+  if (0U < sr->used) {
+    sr->pending = true;
+    sr->cb_transfer_async(sr, sr->buf, sr->used, s_transfer_done);
+    sr->used = 0U;
+  }
+  if (wait) {
+    s_wait_pending(sr);
+  }
+}
+
+static uint8_t s_ctrl_bits(const hd44780_sr595* const sr, hd44780_pin_state rs) {
+  uint8_t ctrl = sr->backlight ? sr->pin_backlight : 0U;
+  if (PIN_SET == rs) {
+    ctrl |= sr->pin_rs;
+  }
+  return ctrl;
+}
+
+static void s_put_byte(hd44780_sr595* const sr, uint8_t ctrl, uint8_t data, bool nibble_mode) {
+  const size_t frames = HD44780_SR595_FRAMES_PER_CHAR + sr->hold_frames;
+  if ((sr->buf_len - sr->used) < frames) {
+    s_send(sr, true);
+  } else {
+    /* Buffer might be still on its way to shift register */
+    s_wait_pending(sr);
+  }
+
+  uint8_t* out = &sr->buf[sr->used];
+  uint8_t port = ctrl;
+  for (uint8_t n = 0U; n < (nibble_mode ? 2U : 1U); n++) {
+    /* Data is latched on falling edge of E */
+    port = ctrl | (uint8_t)(((data >> 4U) & 0x0FU) << sr->data_shift);
+    *out++ = port | sr->pin_e;
+    *out++ = port;
+    data = (uint8_t)(data << 4U);
+  }
+  memset(out, port, sr->hold_frames);
+  sr->used += (size_t)(out - &sr->buf[sr->used]) + sr->hold_frames;
+}
+
+/* "Public" functions implementation */
+
+void hd44780_sr595_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode) {
+  hd44780_sr595* const sr = (hd44780_sr595*)ctx->user_data;
+  s_put_byte(sr, s_ctrl_bits(sr, rs), data, nibble_mode);
+  if (!sr->collecting) {
+    s_send(sr, true);
+  }
+}
+
+void hd44780_sr595_write_data_run(const hd44780_ctx* const ctx, const uint8_t* data, size_t len, bool nibble_mode) {
+  hd44780_sr595* const sr = (hd44780_sr595*)ctx->user_data;
+  const uint8_t ctrl = s_ctrl_bits(sr, PIN_SET);
+  for (size_t i = 0U; i < len; i++) {
+    s_put_byte(sr, ctrl, data[i], nibble_mode);
+  }
+  if (!sr->collecting) {
+    s_send(sr, true);
+  }
+}
+
+void hd44780_sr595_flush_begin(const hd44780_ctx* const ctx) {
+  hd44780_sr595* const sr = (hd44780_sr595*)ctx->user_data;
+  s_wait_pending(sr);
+  sr->collecting = true;
+}
+
+void hd44780_sr595_flush_end(const hd44780_ctx* const ctx) {
+  hd44780_sr595* const sr = (hd44780_sr595*)ctx->user_data;
+  sr->collecting = false;
+  s_send(sr, false);
+}
+
+void hd44780_sr595_wait(const hd44780_ctx* const ctx) {
+  s_wait_pending((hd44780_sr595*)ctx->user_data);
+}
+
+void hd44780_sr595_set_backlight(const hd44780_ctx* const ctx, bool on) {
+  hd44780_sr595* const sr = (hd44780_sr595*)ctx->user_data;
+  if (sr->used == sr->buf_len) {
+    s_send(sr, true);
+  } else {
+    s_wait_pending(sr);
+  }
+  sr->backlight = on;
+  /* E stays low, display does not see this frame */
+  sr->buf[sr->used++] = s_ctrl_bits(sr, PIN_RESET);
+  if (!sr->collecting) {
+    s_send(sr, true);
+  }
+}
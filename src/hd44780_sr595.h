@@ -0,0 +1,192 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#ifndef __HD44780_SR595__H__
+#define __HD44780_SR595__H__
+
+#include "hd44780.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 74HC595 shift register transport, e.g. driven by SPI with DMA. Every byte of
+ * transfer is one frame - state of shift register outputs latched after it
+ * (RCLK driven by hardware chip select pulse between SPI frames). RS, E, backlight
+ * and D4 ... D7 are packed into frames, E high and low for each nibble.
+ *
+ * Single writes are sent right away and waited for. Framebuffer flush is collected
+ * into transfer buffer and handed to cb_transfer_async at once, so DMA moves it
+ * while CPU sleeps, following write waits for completion.
+ *
+ * Display is driven in 4 bit write only mode, RW pin has to be kept low:
+ *
+ *   static uint8_t lcd_spi_buf[512];
+ *   static hd44780_sr595 lcd_sr = HD44780_SR595_DEFAULT(lcd_spi_buf,
+ *     HD44780_SR595_HOLD_FRAMES(1000000U, HD44780_EXEC_TIME_SCALE_PCT), lcd_spi_start_dma);
+ *   static const hd44780_ctx lcd_ctx = {
+ *     .cb_write_cycle = hd44780_sr595_write_cycle,
+ *     .cb_write_data_run = hd44780_sr595_write_data_run,
+ *     .cb_flush_begin = hd44780_sr595_flush_begin,
+ *     .cb_flush_end = hd44780_sr595_flush_end,
+ *     .interface = INTERFACE_4BIT,
+ *     .write_only = true,
+ *     .user_data = &lcd_sr,
+ *     ...
+ *   };
+ *
+ *   void DMA_IRQHandler(void) {
+ *     lcd_sr_done(&lcd_sr);     <- done_cb passed to lcd_spi_start_dma()
+ *   }
+ */
+
+/** @brief Frames per display byte without hold frames - E high and low for each nibble */
+#define HD44780_SR595_FRAMES_PER_CHAR (4U)
+
+/**
+ * @brief Hold frames keeping display bytes 37us scaled by scale_pct apart
+ *
+ * @details Controller executes byte from E falling edge of its second nibble (last
+ *          frame before hold frames) to E falling edge of first nibble of the next
+ *          byte, which comes 2 frames after hold frames. Frame is 8 SPI clocks,
+ *          e.g. 5 at 1MHz and 150%, 0 up to 288kHz
+ *
+ * @param spi_hz SPI clock [Hz]
+ * @param scale_pct execution time scale, HD44780_EXEC_TIME_SCALE_PCT or exec_time_scale_pct [%]
+ */
+#define HD44780_SR595_HOLD_FRAMES(spi_hz, scale_pct)                  \
+  ((uint8_t)((HD44780_SR595_MIN_FRAMES(spi_hz, scale_pct) > 2U) ?    \
+             (HD44780_SR595_MIN_FRAMES(spi_hz, scale_pct) - 2U) : 0U))
+
+/** @brief Frames between E falling edges of consecutive bytes required by HD44780_SR595_HOLD_FRAMES(), rounded up */
+#define HD44780_SR595_MIN_FRAMES(spi_hz, scale_pct) \
+  (((37ULL * (scale_pct) * (spi_hz)) + 799999999ULL) / 800000000ULL)
+
+/* Forward declaration of struct */
+struct hd44780_sr595_s;
+
+/**
+ * @brief Transfer completion callback, has to be called by application when transfer is done
+ *
+ * @param[in] sr transport passed to cb_transfer_async
+ */
+typedef void (*hd44780_sr595_done_cb)(struct hd44780_sr595_s* const sr);
+
+/**
+ * @brief Shift register transport, pointed by user_data of driver context
+ *
+ * @details Pins are given as output bit masks, D4 ... D7 have to be
+ *          consecutive outputs starting from data_shift
+ */
+typedef struct hd44780_sr595_s {
+  uint8_t pin_rs;            /**< RS output mask */
+  uint8_t pin_e;             /**< E output mask */
+  uint8_t pin_backlight;     /**< Backlight output mask, 0 if not connected */
+  uint8_t data_shift;        /**< Output of D4 */
+  bool backlight;            /**< Backlight on */
+  /**
+   * @brief Frames with E low appended to each display byte
+   *
+   * @details E falling edges of consecutive display bytes have to be at least 37us
+   *          (scaled by exec_time_scale_pct) apart: (2 + hold_frames) * frame time,
+   *          e.g. 5 at 1MHz SPI clock (8us frame) and default 150% scale,
+   *          HD44780_SR595_HOLD_FRAMES() computes it
+   */
+  uint8_t hold_frames;
+  uint8_t* buf;              /**< Transfer buffer, DMA capable memory */
+  size_t buf_len;            /**< Transfer buffer length, at least frames of one display byte */
+  /**
+   * @brief Callback starting transfer
+   *
+   * @details Has to call done_cb(sr) once transfer is complete, from interrupt
+   *          or before it returns
+   *
+   * @param[in] sr transport
+   * @param[in] data frames
+   * @param[in] len number of frames
+   * @param[in] done_cb completion callback
+   */
+  void (*cb_transfer_async)(struct hd44780_sr595_s* const sr, const uint8_t* data, size_t len, hd44780_sr595_done_cb done_cb);
+  /**
+   * @brief Optional callback called while waiting for transfer completion, e.g. to sleep until interrupt
+   */
+  void (*cb_wait_idle)(void);
+  size_t used;               /**< Frames collected in buffer, private to transport */
+  bool collecting;           /**< Framebuffer flush is being collected, private to transport */
+  volatile bool pending;     /**< Transfer is in progress, private to transport */
+} hd44780_sr595;
+
+/**
+ * @brief Outputs QA RS, QB E, QC backlight, QD unused, QE ... QH D4 ... D7
+ *
+ * @param buffer transfer buffer array
+ * @param hold number of hold frames
+ * @param transfer transfer start callback
+ */
+#define HD44780_SR595_DEFAULT(buffer, hold, transfer)                                     \
+  {                                                                                       \
+    .pin_rs = 0x01U, .pin_e = 0x02U, .pin_backlight = 0x04U, .data_shift = 4U,            \
+    .backlight = true, .hold_frames = (hold), .buf = (buffer), .buf_len = sizeof(buffer), \
+    .cb_transfer_async = (transfer),                                                      \
+  }
+
+/**
+ * @brief Write cycle of driver context (cb_write_cycle), sent and waited for
+ *        unless flush is collected
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sr595
+ * @param[in] rs RS pin state (instruction or data register)
+ * @param[in] data data to be written
+ * @param[in] nibble_mode whole byte has to be sent as two nibbles
+ */
+void hd44780_sr595_write_cycle(const hd44780_ctx* const ctx, hd44780_pin_state rs, uint8_t data, bool nibble_mode);
+
+/**
+ * @brief Data run write of driver context (cb_write_data_run), sent and waited for
+ *        unless flush is collected
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sr595
+ * @param[in] data bytes to be written
+ * @param[in] len number of bytes
+ * @param[in] nibble_mode every byte has to be sent as two nibbles
+ */
+void hd44780_sr595_write_data_run(const hd44780_ctx* const ctx, const uint8_t* data, size_t len, bool nibble_mode);
+
+/**
+ * @brief Start collecting framebuffer flush (cb_flush_begin)
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sr595
+ */
+void hd44780_sr595_flush_begin(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Start transfer of collected flush without waiting for it (cb_flush_end)
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sr595
+ */
+void hd44780_sr595_flush_end(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Wait until transfer in progress is done
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sr595
+ */
+void hd44780_sr595_wait(const hd44780_ctx* const ctx);
+
+/**
+ * @brief Turn backlight on or off
+ *
+ * @param[in] ctx driver context, user_data points hd44780_sr595
+ * @param[in] on backlight state
+ */
+void hd44780_sr595_set_backlight(const hd44780_ctx* const ctx, bool on);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HD44780_SR595__H__ */
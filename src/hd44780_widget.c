@@ -0,0 +1,218 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#include "hd44780_widget.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define CGRAM_CHARS      (8U)
+#define BAR_MAX_WIDTH    (40U)
+#define BAR_UNKNOWN      (0xFFFFU)
+
+#define BIG_FULL         (0U)
+#define BIG_TOP          (1U)
+#define BIG_BOTTOM       (2U)
+#define BIG_BOTH         (3U)
+#define BIG_SPACE        (0xFFU)
+#define BIG_MINUS        (10U)
+#define BIG_BLANK        (11U)
+
+/* Cells of upper row followed by cells of lower row, bottom bar of upper row is middle segment */
+static const uint8_t s_bigdigit_font[12U][2U * HD44780_BIGDIGIT_WIDTH] = {
+  { BIG_FULL,   BIG_TOP,    BIG_FULL,   BIG_FULL,   BIG_BOTTOM, BIG_FULL   },  /* 0 */
+  { BIG_TOP,    BIG_FULL,   BIG_SPACE,  BIG_BOTTOM, BIG_FULL,   BIG_BOTTOM },  /* 1 */
+  { BIG_BOTH,   BIG_BOTH,   BIG_FULL,   BIG_FULL,   BIG_BOTTOM, BIG_BOTTOM },  /* 2 */
+  { BIG_BOTH,   BIG_BOTH,   BIG_FULL,   BIG_BOTTOM, BIG_BOTTOM, BIG_FULL   },  /* 3 */
+  { BIG_FULL,   BIG_BOTTOM, BIG_FULL,   BIG_SPACE,  BIG_SPACE,  BIG_FULL   },  /* 4 */
+  { BIG_FULL,   BIG_BOTH,   BIG_BOTH,   BIG_BOTTOM, BIG_BOTTOM, BIG_FULL   },  /* 5 */
+  { BIG_FULL,   BIG_BOTH,   BIG_BOTH,   BIG_FULL,   BIG_BOTTOM, BIG_FULL   },  /* 6 */
+  { BIG_TOP,    BIG_TOP,    BIG_FULL,   BIG_SPACE,  BIG_SPACE,  BIG_FULL   },  /* 7 */
+  { BIG_FULL,   BIG_BOTH,   BIG_FULL,   BIG_FULL,   BIG_BOTTOM, BIG_FULL   },  /* 8 */
+  { BIG_FULL,   BIG_BOTH,   BIG_FULL,   BIG_BOTTOM, BIG_BOTTOM, BIG_FULL   },  /* 9 */
+  { BIG_BOTTOM, BIG_BOTTOM, BIG_BOTTOM, BIG_SPACE,  BIG_SPACE,  BIG_SPACE  },  /* - */
+  { BIG_SPACE,  BIG_SPACE,  BIG_SPACE,  BIG_SPACE,  BIG_SPACE,  BIG_SPACE  },  /* blank */
+};
+
+/* Static, "private" functions declarations */
+
+/**
+ * @brief Move to position of framebuffer render or display
+ *
+ * @param[in] ctx driver context
+ * @param[in] row row number
+ * @param[in] column column number
+ *
+ * @return status of hd44780_fb_set_pos() or hd44780_set_pos()
+ */
+static hd44780_ret_e s_goto(const hd44780_ctx* const ctx, uint8_t row, uint8_t column);
+
+/**
+ * @brief Write character codes into framebuffer or display
+ *
+ * @param[in] ctx driver context
+ * @param[in] codes display character codes
+ * @param[in] len number of codes
+ *
+ * @return status of hd44780_fb_write_raw() or hd44780_write_raw()
+ */
+static hd44780_ret_e s_emit(const hd44780_ctx* const ctx, const uint8_t* codes, size_t len);
+
+/**
+ * @brief Get character code of bar cell
+ *
+ * @param[in] bar bar graph
+ * @param[in] pixels filled pixel columns of bar
+ * @param[in] cell cell index
+ *
+ * @return display character code
+ */
+static uint8_t s_bar_code(const hd44780_bar* const bar, uint16_t pixels, uint8_t cell);
+
+/* Static functions implementation */
+
+static hd44780_ret_e s_goto(const hd44780_ctx* const ctx, uint8_t row, uint8_t column) {
+  return (NULL != ctx->framebuffer) ? hd44780_fb_set_pos(ctx, row, column) : hd44780_set_pos(ctx, row, column);
+}
+
+static hd44780_ret_e s_emit(const hd44780_ctx* const ctx, const uint8_t* codes, size_t len) {
+  return (NULL != ctx->framebuffer) ? hd44780_fb_write_raw(ctx, codes, len) : hd44780_write_raw(ctx, codes, len);
+}
+
+static uint8_t s_bar_code(const hd44780_bar* const bar, uint16_t pixels, uint8_t cell) {
+  const uint16_t start = (uint16_t)cell * HD44780_BAR_CELL_STEPS;
+  uint8_t code = ' ';
+
+  if (start < pixels) {
+    const uint16_t fill = pixels - start;
+    code = (uint8_t)(bar->first_char + ((fill < HD44780_BAR_CELL_STEPS) ? fill : HD44780_BAR_CELL_STEPS) - 1U);
+  }
+  return code;
+}
+
+/* "Public" functions implementation */
+
+hd44780_ret_e hd44780_bar_init(const hd44780_ctx* const ctx, hd44780_bar* const bar) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  if ((0U == bar->width) || (BAR_MAX_WIDTH < bar->width) || (ctx->number_of_lines <= bar->row) ||
+      (ctx->column_width < (bar->column + bar->width)) || (CGRAM_CHARS < (bar->first_char + HD44780_BAR_CHARS))) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < HD44780_BAR_CHARS); i++) {
+    /* Pixel columns are filled from the left */
+    uint8_t pattern[8U];
+    memset(pattern, (uint8_t)(0x1FU << (HD44780_BAR_CHARS - 1U - i)) & 0x1FU, sizeof(pattern));
+    ret = hd44780_def_char_diff(ctx, (uint8_t)(bar->first_char + i), pattern);
+  }
+  if (HD44780_OK == ret) {
+    bar->shown = BAR_UNKNOWN;
+    ret = hd44780_bar_set(ctx, bar, 0U, 1U);
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_bar_set(const hd44780_ctx* const ctx, hd44780_bar* const bar, uint16_t value, uint16_t max) {
+  hd44780_ret_e ret = HD44780_OK;
+  const bool fb = (NULL != ctx->framebuffer);
+  uint8_t codes[BAR_MAX_WIDTH];
+
+  if ((0U == max) || (BAR_MAX_WIDTH < bar->width)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  const uint32_t steps = (uint32_t)bar->width * HD44780_BAR_CELL_STEPS;
+  const uint16_t pixels = (uint16_t)((((value < max) ? value : max) * steps) / max);
+  for (uint8_t i = 0U; i < bar->width; i++) {
+    codes[i] = s_bar_code(bar, pixels, i);
+  }
+
+  uint8_t cell = 0U;
+  while ((HD44780_OK == ret) && (cell < bar->width)) {
+    /* Framebuffer gets every cell, flush compares them anyway */
+    const bool known = (!fb) && (BAR_UNKNOWN != bar->shown);
+    if (known && (codes[cell] == s_bar_code(bar, bar->shown, cell))) {
+      cell++;
+      continue;
+    }
+
+    uint8_t end = cell + 1U;
+    while ((end < bar->width) && ((!known) || (codes[end] != s_bar_code(bar, bar->shown, end)))) {
+      end++;
+    }
+    ret = s_goto(ctx, bar->row, (uint8_t)(bar->column + cell));
+    if (HD44780_OK == ret) {
+      ret = s_emit(ctx, &codes[cell], end - cell);
+    }
+    cell = end;
+  }
+  if (HD44780_OK == ret) {
+    bar->shown = fb ? BAR_UNKNOWN : pixels;
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_bigdigit_init(const hd44780_ctx* const ctx, uint8_t first_char) {
+  static const uint8_t patterns[HD44780_BIGDIGIT_CHARS][8U] = {
+    { 0x1FU, 0x1FU, 0x1FU, 0x1FU, 0x1FU, 0x1FU, 0x1FU, 0x1FU },  /* full block, same as full bar cell */
+    { 0x1FU, 0x1FU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U },  /* top bar */
+    { 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x1FU, 0x1FU },  /* bottom bar */
+    { 0x1FU, 0x1FU, 0x00U, 0x00U, 0x00U, 0x00U, 0x1FU, 0x1FU },  /* top and bottom bars */
+  };
+  hd44780_ret_e ret = HD44780_OK;
+
+  if (CGRAM_CHARS < (first_char + HD44780_BIGDIGIT_CHARS)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  for (uint8_t i = 0U; (HD44780_OK == ret) && (i < HD44780_BIGDIGIT_CHARS); i++) {
+    ret = hd44780_def_char_diff(ctx, (uint8_t)(first_char + i), patterns[i]);
+  }
+
+exit:
+  return ret;
+}
+
+hd44780_ret_e hd44780_bigdigit_write(const hd44780_ctx* const ctx, uint8_t first_char, uint8_t row, uint8_t column,
+                                     const char* digits) {
+  hd44780_ret_e ret = HD44780_OK;
+
+  if ((ctx->number_of_lines <= (row + 1U)) || (ctx->column_width <= column)) {
+    ret = HD44780_INV_ARG;
+    goto exit;
+  }
+
+  for (uint8_t half = 0U; (HD44780_OK == ret) && (half < 2U); half++) {
+    ret = s_goto(ctx, (uint8_t)(row + half), column);
+    uint8_t at = column;
+    for (const char* d = digits; (HD44780_OK == ret) && ('\0' != *d) && (at < ctx->column_width); d++) {
+      uint8_t glyph = BIG_BLANK;
+      if (('0' <= *d) && (*d <= '9')) {
+        glyph = (uint8_t)(*d - '0');
+      } else if ('-' == *d) {
+        glyph = BIG_MINUS;
+      }
+
+      uint8_t codes[HD44780_BIGDIGIT_WIDTH + 1U] = { ' ', ' ', ' ', ' ' };
+      for (uint8_t i = 0U; i < HD44780_BIGDIGIT_WIDTH; i++) {
+        const uint8_t cell = s_bigdigit_font[glyph][(half * HD44780_BIGDIGIT_WIDTH) + i];
+        codes[i] = (BIG_SPACE == cell) ? (uint8_t)' ' : (uint8_t)(first_char + cell);
+      }
+      /* Direct write would run into the next row */
+      uint8_t len = ('\0' != d[1]) ? (HD44780_BIGDIGIT_WIDTH + 1U) : HD44780_BIGDIGIT_WIDTH;
+      len = ((ctx->column_width - at) < len) ? (uint8_t)(ctx->column_width - at) : len;
+      ret = s_emit(ctx, codes, len);
+      at = (uint8_t)(at + len);
+    }
+  }
+
+exit:
+  return ret;
+}
@@ -0,0 +1,126 @@
+/* Dariusz Sabala, 2023, MIT License, https://github.com/dsabala/hd44780 */
+
+#ifndef __HD44780_WIDGET__H__
+#define __HD44780_WIDGET__H__
+
+#include "hd44780.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Widgets drawn with fixed set of CGRAM characters. Glyphs are defined once with
+ * hd44780_def_char_diff(), so repeated init costs no bus access. Widgets render
+ * into framebuffer when context has one, otherwise they write to display directly.
+ *
+ * Bar uses HD44780_BAR_CHARS characters, big digits HD44780_BIGDIGIT_CHARS. Both
+ * fit in CGRAM at once when bar starts at character 0 and big digits at 4, they
+ * share full block glyph:
+ *
+ *   static hd44780_bar level = { .row = 1, .column = 0, .width = 16, .first_char = 0 };
+ *   hd44780_bar_init(lcd_ctx, &level);
+ *   hd44780_bigdigit_init(lcd_ctx, 4);
+ *
+ *   hd44780_bar_set(lcd_ctx, &level, adc_value, 4095);   <- only changed cells are written
+ *   hd44780_bigdigit_write(lcd_ctx, 4, 0, 0, "42");
+ *
+ * CGRAM characters used by widgets must not be used by custom_chars_map.
+ */
+
+/** @brief CGRAM characters used by bar - 1 ... 5 filled pixel columns */
+#define HD44780_BAR_CHARS         (5U)
+/** @brief Pixel columns of one character cell */
+#define HD44780_BAR_CELL_STEPS    (5U)
+/** @brief CGRAM characters used by big digits - full block, top, bottom, top and bottom bars */
+#define HD44780_BIGDIGIT_CHARS    (4U)
+/** @brief Columns of one big digit, followed by one column of space */
+#define HD44780_BIGDIGIT_WIDTH    (3U)
+
+/**
+ * @brief Horizontal bar graph
+ *
+ * @details Object is modified by driver, it remembers fill shown on display
+ */
+typedef struct {
+  uint8_t row;          /**< Row of bar */
+  uint8_t column;       /**< Column of leftmost bar cell */
+  uint8_t width;        /**< Length of bar in cells */
+  uint8_t first_char;   /**< First of HD44780_BAR_CHARS consecutive CGRAM characters */
+  uint16_t shown;       /**< Filled pixel columns on display, private to driver */
+} hd44780_bar;
+
+/**
+ * @brief Define bar glyphs and draw empty bar
+ *
+ * @param[in] ctx driver context
+ * @param[in,out] bar bar graph
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Bar does not fit in display or CGRAM
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_bar_init(const hd44780_ctx* const ctx, hd44780_bar* const bar);
+
+/**
+ * @brief Set bar fill, directly written display gets only cells which fill changed
+ *
+ * @details Framebuffer gets whole bar, flush sends only changed cells anyway.
+ *          Call hd44780_bar_init() again after display has been cleared.
+ *
+ * @param[in] ctx driver context
+ * @param[in,out] bar bar graph
+ * @param[in] value bar value, clipped to max
+ * @param[in] max value of full bar
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Zero max
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_bar_set(const hd44780_ctx* const ctx, hd44780_bar* const bar, uint16_t value, uint16_t max);
+
+/**
+ * @brief Define big digit glyphs
+ *
+ * @param[in] ctx driver context
+ * @param[in] first_char first of HD44780_BIGDIGIT_CHARS consecutive CGRAM characters
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Glyphs does not fit in CGRAM
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_bigdigit_init(const hd44780_ctx* const ctx, uint8_t first_char);
+
+/**
+ * @brief Write big digits, two rows high and HD44780_BIGDIGIT_WIDTH columns wide
+ *
+ * @details Digits are separated by one column of space, characters other
+ *          than '0' ... '9' and '-' are drawn as space
+ *
+ * @param[in] ctx driver context
+ * @param[in] first_char first character passed to hd44780_bigdigit_init()
+ * @param[in] row upper row of digits
+ * @param[in] column column of first digit
+ * @param[in] digits null terminated string
+ *
+ * @note Digits that does not fit in the row are clipped
+ *
+ * @return status
+ * @retval HD44780_OK      Success
+ * @retval HD44780_INV_ARG Invalid position
+ * @retval HD44780_TIMEOUT Timeout
+ */
+hd44780_ret_e hd44780_bigdigit_write(const hd44780_ctx* const ctx, uint8_t first_char, uint8_t row, uint8_t column,
+                                     const char* digits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HD44780_WIDGET__H__ */